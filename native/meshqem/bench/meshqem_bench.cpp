@@ -0,0 +1,326 @@
+// meshqem_bench.cpp — Micro and end-to-end benchmarks for meshqem, with JSON output.
+//
+// Usage: meshqem_bench [--max-tris n] [--filter substr] [--threads n] [--quick] [--out file.json]
+//
+// - Micro: plane_quadric, quadric_eval, solve3, heap push/pop of EdgeCand, collapse step
+//   (collapse loop throughput taken from SimplifyStats on a simplify run).
+// - End-to-end: qem_simplify, load_obj_tri, save_obj_tri on procedural meshes (wavy grid,
+//   sphere, noisy scan) from 10K triangles up to --max-tris (default 1M; 10M available);
+//   triangulate_fan / triangulate_earclip on the wavy grid as quads with face-varying UVs;
+//   reorder_for_vertex_cache on each input mesh (throughput in faces/s);
+//   qem_simplify_partitioned / qem_simplify_deterministic: partitions = -1 with one cluster per
+//   thread (the fast path) against opt.deterministic (cluster count from the face count), so
+//   the cost of thread-independent output shows next to it. Both record the cluster count.
+//
+// Every result records seconds, a throughput and the process peak RSS so far (getrusage),
+// so a run is one JSON document that can be diffed between releases. Not part of ctest.
+//
+#include "io_obj.hpp"
+#include "polygon.hpp"
+#include "qem.hpp"
+#include "quadric.hpp"
+#include "reorder.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+static double seconds_since(Clock::time_point t0) { return std::chrono::duration<double>(Clock::now() - t0).count(); }
+
+// Peak resident set size of this process so far, in KiB (0 where unavailable).
+static long peak_rss_kb() {
+#if defined(__unix__) || defined(__APPLE__)
+    rusage ru{};
+    getrusage(RUSAGE_SELF, &ru);
+#if defined(__APPLE__)
+    return ru.ru_maxrss / 1024;  // bytes on macOS
+#else
+    return ru.ru_maxrss;
+#endif
+#else
+    return 0;
+#endif
+}
+
+// Deterministic hash-based noise in [-1, 1] so every run benchmarks identical meshes.
+static double hash_noise(uint64_t x) {
+    x ^= x >> 33; x *= 0xff51afd7ed558ccdULL; x ^= x >> 33; x *= 0xc4ceb9fe1a85ec53ULL; x ^= x >> 33;
+    return (double)(x >> 11) * (2.0 / 9007199254740992.0) - 1.0;
+}
+
+// Heightfield grid with ~`tris` triangles: smooth waves, so quadrics are well conditioned
+// in the interior and nearly planar (fallback-heavy) near the flat crests.
+static Mesh make_grid(size_t tris) {
+    int n = std::max(2, (int)std::sqrt((double)tris / 2));
+    Mesh m;
+    m.verts.reserve((size_t)(n + 1) * (n + 1));
+    for (int j = 0; j <= n; ++j)
+        for (int i = 0; i <= n; ++i) {
+            double x = (double)i / n, y = (double)j / n;
+            m.verts.push_back({x, y, 0.05 * std::sin(12 * x) * std::cos(9 * y)});
+        }
+    m.faces.reserve((size_t)2 * n * n);
+    for (int j = 0; j < n; ++j)
+        for (int i = 0; i < n; ++i) {
+            int a = j * (n + 1) + i, b = a + 1, c = a + n + 1, d = c + 1;
+            m.faces.push_back({a, b, d});
+            m.faces.push_back({a, d, c});
+        }
+    return m;
+}
+
+// UV sphere with ~`tris` triangles; `noise` > 0 perturbs radii like a raw scan.
+static Mesh make_sphere(size_t tris, double noise) {
+    int rings = std::max(3, (int)std::sqrt((double)tris / 4)), segs = 2 * rings;
+    const double pi = 3.14159265358979323846;
+    Mesh m;
+    m.verts.push_back({0, 0, 1 + noise * hash_noise(1)});
+    for (int r = 1; r < rings; ++r)
+        for (int s = 0; s < segs; ++s) {
+            double th = pi * r / rings, ph = 2 * pi * s / segs;
+            double rad = 1 + noise * hash_noise((uint64_t)r * 1000003u + (uint64_t)s + 2);
+            m.verts.push_back({rad * std::sin(th) * std::cos(ph), rad * std::sin(th) * std::sin(ph), rad * std::cos(th)});
+        }
+    m.verts.push_back({0, 0, -1 - noise * hash_noise(2)});
+    const int south = (int)m.verts.size() - 1;
+    auto at = [segs](int r, int s) { return 1 + (r - 1) * segs + s % segs; };
+    for (int s = 0; s < segs; ++s) m.faces.push_back({0, at(1, s), at(1, s + 1)});
+    for (int r = 1; r + 1 < rings; ++r)
+        for (int s = 0; s < segs; ++s) {
+            m.faces.push_back({at(r, s), at(r + 1, s), at(r + 1, s + 1)});
+            m.faces.push_back({at(r, s), at(r + 1, s + 1), at(r, s + 1)});
+        }
+    for (int s = 0; s < segs; ++s) m.faces.push_back({south, at(rings - 1, s + 1), at(rings - 1, s)});
+    return m;
+}
+
+struct Result {
+    std::string name, kind, mesh, unit;
+    size_t size = 0;          // triangles (e2e) or operations (micro)
+    double seconds = 0, throughput = 0;
+    long peak_rss_kb = 0;
+};
+
+struct Bench {
+    std::vector<Result> results;
+    std::string filter;
+    bool enabled(const std::string& name) const { return filter.empty() || name.find(filter) != std::string::npos; }
+    void add(Result r) {
+        r.peak_rss_kb = peak_rss_kb();
+        fprintf(stderr, "%-28s %-10s %10zu  %9.4f s  %12.4g %s\n", r.name.c_str(), r.mesh.c_str(), r.size, r.seconds, r.throughput, r.unit.c_str());
+        results.push_back(std::move(r));
+    }
+};
+
+static volatile double g_sink;  // keeps micro-benchmark results alive
+
+// Random-ish quadric inputs shared by the kernel benchmarks.
+static std::vector<Quadric> make_quadrics(size_t n) {
+    std::vector<Quadric> qs(n);
+    for (size_t i = 0; i < n; ++i) {
+        Quadric Q; q_zero(Q);
+        for (int k = 0; k < 3; ++k) {  // three planes: a well-conditioned vertex quadric
+            double a = hash_noise(i * 11 + k), b = hash_noise(i * 13 + k + 5), c = hash_noise(i * 17 + k + 9);
+            double L = std::sqrt(a * a + b * b + c * c) + 1e-9;
+            q_add(Q, plane_quadric(a / L, b / L, c / L, hash_noise(i * 19 + k)));
+        }
+        qs[i] = Q;
+    }
+    return qs;
+}
+
+static void bench_micro(Bench& B, size_t ops) {
+    const size_t n = 4096;  // working set stays in L1/L2: these measure the kernels, not memory
+    std::vector<Quadric> qs = make_quadrics(n);
+    auto micro = [&](const char* name, size_t count, double secs) {
+        B.add({name, "micro", "-", "ops/s", count, secs, count / secs});
+    };
+    if (B.enabled("plane_quadric")) {
+        auto t0 = Clock::now(); double acc = 0;
+        for (size_t i = 0; i < ops; ++i) { double a = 0.001 * (double)(i & 1023); Quadric K = plane_quadric(a, 0.5, 0.25, 1.0 - a); acc += K.m[(i & 7) + 1]; }
+        g_sink = acc; micro("plane_quadric", ops, seconds_since(t0));
+    }
+    if (B.enabled("quadric_eval")) {
+        auto t0 = Clock::now(); double acc = 0;
+        for (size_t i = 0; i < ops; ++i) { double v[4] = {0.1 * (double)(i & 15), 0.2, 0.3, 1.0}; acc += quadric_eval(qs[i & (n - 1)], v); }
+        g_sink = acc; micro("quadric_eval", ops, seconds_since(t0));
+    }
+    if (B.enabled("solve3")) {
+        auto t0 = Clock::now(); double acc = 0;
+        for (size_t i = 0; i < ops; ++i) {
+            Quadric Q = q_sum(qs[i & (n - 1)], qs[(i * 7 + 3) & (n - 1)]);
+            double A[9], b[3], x[3] = {0, 0, 0}; quadric_system(Q, A, b);
+            if (solve3(A, b, x)) acc += x[0];
+        }
+        g_sink = acc; micro("solve3", ops, seconds_since(t0));
+    }
+    if (B.enabled("heap_push_pop")) {
+        // Steady-state heap of 1M candidates: each op is one pop followed by one push.
+        std::vector<EdgeCand> heap(1 << 20);
+        for (size_t i = 0; i < heap.size(); ++i) heap[i] = {(int)i, (int)i + 1, 0, 0, hash_noise(i) + 1.0};
+        std::make_heap(heap.begin(), heap.end());
+        auto t0 = Clock::now();
+        for (size_t i = 0; i < ops / 4; ++i) {
+            std::pop_heap(heap.begin(), heap.end());
+            EdgeCand e = heap.back(); heap.pop_back();
+            e.cost += 0.5 + 0.25 * hash_noise(i);
+            heap.push_back(e); std::push_heap(heap.begin(), heap.end());
+        }
+        g_sink = heap.front().cost; micro("heap_push_pop", ops / 4, seconds_since(t0));
+    }
+}
+
+static void bench_mesh(Bench& B, const std::string& label, const Mesh& mesh, int threads, const std::string& tmp_path) {
+    const size_t tris = mesh.faces.size();
+    if (B.enabled("qem_simplify") || B.enabled("collapse_step")) {
+        Mesh m = mesh; SimplifyOptions opt; SimplifyReport rep;
+        opt.ratio = 0.1; opt.threads = threads; opt.progress_interval = 1 << 30; opt.collect_stats = true;
+        auto t0 = Clock::now();
+        qem_simplify(m, opt, rep);
+        double secs = seconds_since(t0);
+        const SimplifyStats& s = rep.stats;
+        if (B.enabled("qem_simplify")) B.add({"qem_simplify", "e2e", label, "collapses/s", tris, secs, s.collapses / secs});
+        if (B.enabled("collapse_step") && s.t_collapse > 0) B.add({"collapse_step", "micro", label, "collapses/s", s.collapses, s.t_collapse, s.collapses / s.t_collapse});
+    }
+    if (B.enabled("qem_simplify_f32")) {
+        MeshF m; m.faces = mesh.faces; m.verts.resize(mesh.verts.size());
+        for (size_t i = 0; i < mesh.verts.size(); ++i) m.verts[i] = {(float)mesh.verts[i].x, (float)mesh.verts[i].y, (float)mesh.verts[i].z};
+        SimplifyOptions opt; SimplifyReport rep;
+        opt.ratio = 0.1; opt.threads = threads; opt.progress_interval = 1 << 30;
+        auto t0 = Clock::now();
+        qem_simplify(m, opt, rep);
+        double secs = seconds_since(t0);
+        B.add({"qem_simplify_f32", "e2e", label, "collapses/s", tris, secs, rep.stats.collapses / secs});
+    }
+    for (int det = 0; det < 2; ++det) {
+        const char* name = det ? "qem_simplify_deterministic" : "qem_simplify_partitioned";
+        if (!B.enabled(name)) continue;
+        Mesh m = mesh; SimplifyOptions opt; SimplifyReport rep;
+        opt.ratio = 0.1; opt.threads = threads; opt.progress_interval = 1 << 30; opt.partitions = -1; opt.deterministic = det != 0;
+        auto t0 = Clock::now();
+        qem_simplify(m, opt, rep);
+        double secs = seconds_since(t0);
+        B.add({name, "e2e", label + "_c" + std::to_string(rep.stats.clusters), "collapses/s", tris, secs, rep.stats.collapses / secs});
+    }
+    if (B.enabled("reorder_for_vertex_cache")) {
+        Mesh m = mesh;
+        auto t0 = Clock::now();
+        reorder_for_vertex_cache(m);
+        double secs = seconds_since(t0);
+        B.add({"reorder_for_vertex_cache", "e2e", label, "faces/s", tris, secs, tris / secs});
+    }
+    if (B.enabled("save_obj_tri") || B.enabled("load_obj_tri")) {
+        std::string err;
+        auto t0 = Clock::now();
+        if (!save_obj_tri(tmp_path, mesh, err, threads)) { fprintf(stderr, "save failed: %s\n", err.c_str()); return; }
+        double save_s = seconds_since(t0);
+        FILE* f = fopen(tmp_path.c_str(), "rb"); long bytes = 0;
+        if (f) { fseek(f, 0, SEEK_END); bytes = ftell(f); fclose(f); }
+        const double mb = bytes / (1024.0 * 1024.0);
+        if (B.enabled("save_obj_tri")) B.add({"save_obj_tri", "e2e", label, "MB/s", tris, save_s, mb / save_s});
+        if (B.enabled("load_obj_tri")) {
+            Mesh m; t0 = Clock::now();
+            if (!load_obj_tri(tmp_path, m, err, threads)) fprintf(stderr, "load failed: %s\n", err.c_str());
+            double load_s = seconds_since(t0);
+            B.add({"load_obj_tri", "e2e", label, "MB/s", tris, load_s, mb / load_s});
+        }
+        std::remove(tmp_path.c_str());
+    }
+}
+
+// The wavy grid's quads as USD-style polygons with face-varying UVs, triangulated both ways.
+static void bench_polygons(Bench& B, const std::string& label, size_t tris, int threads) {
+    if (!B.enabled("triangulate_fan") && !B.enabled("triangulate_earclip")) return;
+    const Mesh grid = make_grid(tris);
+    const int n = (int)std::sqrt((double)grid.verts.size()) - 1;
+    std::vector<int> counts((size_t)n * n, 4), indices;
+    std::vector<double> uvs;
+    indices.reserve(counts.size() * 4); uvs.reserve(counts.size() * 8);
+    for (int j = 0; j < n; ++j)
+        for (int i = 0; i < n; ++i)
+            for (int c : {j * (n + 1) + i, j * (n + 1) + i + 1, (j + 1) * (n + 1) + i + 1, (j + 1) * (n + 1) + i}) {
+                indices.push_back(c); uvs.push_back(grid.verts[c].x); uvs.push_back(grid.verts[c].y);
+            }
+    PolygonInput in;
+    in.counts = counts.data(); in.num_polys = counts.size();
+    in.indices = indices.data(); in.num_indices = indices.size();
+    in.uvs = uvs.data(); in.num_uvs = indices.size();
+    for (Triangulation mode : {Triangulation::Fan, Triangulation::EarClip}) {
+        const char* name = mode == Triangulation::Fan ? "triangulate_fan" : "triangulate_earclip";
+        if (!B.enabled(name)) continue;
+        Mesh m; m.verts = grid.verts; std::string err;
+        auto t0 = Clock::now();
+        if (!triangulate_polygons(m, in, mode, true, err, threads)) { fprintf(stderr, "triangulate failed: %s\n", err.c_str()); return; }
+        const double secs = seconds_since(t0);
+        B.add({name, "e2e", label, "tris/s", m.faces.size(), secs, m.faces.size() / secs});
+    }
+}
+
+static std::string json_escape(const std::string& s) {
+    std::string o;
+    for (char c : s) { if (c == '"' || c == '\\') o += '\\'; o += c; }
+    return o;
+}
+
+static void write_json(const Bench& B, FILE* out, int threads, size_t max_tris) {
+    fprintf(out, "{\n  \"version\": \"%s\",\n  \"threads\": %d,\n  \"max_tris\": %zu,\n  \"results\": [\n", MEQ_VERSION, threads, max_tris);
+    for (size_t i = 0; i < B.results.size(); ++i) {
+        const Result& r = B.results[i];
+        fprintf(out, "    {\"name\": \"%s\", \"kind\": \"%s\", \"mesh\": \"%s\", \"size\": %zu, \"seconds\": %.6f, "
+                     "\"throughput\": %.6g, \"unit\": \"%s\", \"peak_rss_kb\": %ld}%s\n",
+                json_escape(r.name).c_str(), r.kind.c_str(), json_escape(r.mesh).c_str(), r.size, r.seconds,
+                r.throughput, r.unit.c_str(), r.peak_rss_kb, i + 1 < B.results.size() ? "," : "");
+    }
+    fprintf(out, "  ]\n}\n");
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Bench B;
+    size_t max_tris = 1000000; int threads = 1; bool quick = false; const char* out_path = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        if (!strcmp(argv[i], "--max-tris") && i + 1 < argc) max_tris = (size_t)std::stoull(argv[++i]);
+        else if (!strcmp(argv[i], "--filter") && i + 1 < argc) B.filter = argv[++i];
+        else if (!strcmp(argv[i], "--threads") && i + 1 < argc) threads = std::stoi(argv[++i]);
+        else if (!strcmp(argv[i], "--quick")) quick = true;
+        else if (!strcmp(argv[i], "--out") && i + 1 < argc) out_path = argv[++i];
+        else {
+            fprintf(stderr, "Usage: meshqem_bench [--max-tris n] [--filter substr] [--threads n] [--quick] [--out file.json]\n");
+            return 2;
+        }
+    }
+
+    bench_micro(B, quick ? 1000000 : 20000000);
+
+    std::string tmp = "meshqem_bench_tmp.obj";
+#if defined(__unix__) || defined(__APPLE__)
+    tmp = "/tmp/meshqem_bench_" + std::to_string((long)getpid()) + ".obj";
+#endif
+    for (size_t tris : {(size_t)10000, (size_t)100000, (size_t)1000000, (size_t)10000000}) {
+        if (tris > max_tris) break;
+        if (quick && tris > 100000) break;
+        const std::string sz = tris >= 1000000 ? std::to_string(tris / 1000000) + "M" : std::to_string(tris / 1000) + "K";
+        bench_mesh(B, "grid_" + sz, make_grid(tris), threads, tmp);
+        bench_mesh(B, "sphere_" + sz, make_sphere(tris, 0.0), threads, tmp);
+        bench_mesh(B, "noisy_" + sz, make_sphere(tris, 0.01), threads, tmp);
+        bench_polygons(B, "quads_" + sz, tris, threads);
+    }
+
+    FILE* out = out_path ? fopen(out_path, "w") : stdout;
+    if (!out) { fprintf(stderr, "cannot write: %s\n", out_path); return 5; }
+    write_json(B, out, threads, max_tris);
+    if (out != stdout) fclose(out);
+    return 0;
+}
@@ -0,0 +1,60 @@
+// batch.cpp — Largest-first scheduling of independent qem_simplify jobs.
+
+#include "batch.hpp"
+#include "thread_pool.hpp"
+#include "parallel.hpp"
+#include "workspace.hpp"
+#include "mesh_cache.hpp"
+#include <algorithm>
+#include <unordered_map>
+
+bool qem_simplify_batch(std::vector<BatchItem>& items, ThreadPool& pool, MeshCache* cache) {
+    // Content keys first (memory-bound, one task per item), then the first item with each
+    // key leads and the rest copy its result.
+    const size_t n = items.size();
+    std::vector<uint64_t> keys(n);
+    for (size_t i = 0; i < n; ++i) pool.submit([&items, &keys, i] { keys[i] = mesh_cache_key(items[i].mesh, items[i].opt); });
+    pool.wait();
+    std::vector<size_t> leader(n);
+    std::unordered_map<uint64_t, size_t> first;
+    std::vector<size_t> order;
+    for (size_t i = 0; i < n; ++i) {
+        auto ins = first.emplace(keys[i], i);
+        leader[i] = ins.first->second;
+        if (ins.second) order.push_back(i);
+    }
+
+    // Order by descending face count; ties keep input order so scheduling is repeatable.
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return items[a].mesh.faces.size() > items[b].mesh.faces.size();
+    });
+    for (size_t i : order) {
+        pool.submit([&items, &keys, cache, i] {
+            BatchItem& it = items[i];
+            Mesh hit;
+            if (cache && cache->get(keys[i], hit)) {
+                fill_cached_report(it.mesh, hit, it.rep);
+                it.mesh = std::move(hit); it.ok = true;
+                return;
+            }
+            static thread_local SimplifyWorkspace ws;  // one per worker, reused by every item it runs
+            it.ok = qem_simplify(it.mesh, it.opt, it.rep, &ws);
+            if (cache && it.ok && cacheable(it.rep)) cache->put(keys[i], it.mesh);
+        });
+    }
+    pool.wait();
+    for (size_t i = 0; i < n; ++i) {
+        if (leader[i] == i) continue;
+        const BatchItem& src = items[leader[i]];
+        BatchItem& it = items[i];
+        fill_cached_report(it.mesh, src.mesh, it.rep);
+        it.mesh = src.mesh; it.ok = src.ok;
+    }
+    return std::all_of(items.begin(), items.end(), [](const BatchItem& it) { return it.ok; });
+}
+
+bool qem_simplify_batch(std::vector<BatchItem>& items, int threads, MeshCache* cache) {
+    if (items.empty()) return true;
+    ThreadPool pool(std::min<int>(resolve_threads(threads), (int)items.size()));
+    return qem_simplify_batch(items, pool, cache);
+}
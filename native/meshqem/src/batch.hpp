@@ -0,0 +1,33 @@
+// batch.hpp — Simplify many independent meshes in one call on a work-stealing pool.
+//
+// Each item carries its own mesh and SimplifyOptions and receives its own report.
+// Items are scheduled largest-first (by face count) so the long jobs start early and the
+// small ones fill in the gaps at the end. Per-item opt.threads still applies to that
+// item's setup phase; leave it at 1 unless the batch is smaller than the pool.
+// Each worker reuses one SimplifyWorkspace for all items it runs (freed with the pool's
+// threads), so scratch allocation happens roughly once per worker instead of per mesh.
+// Items with the same content and options (instanced meshes) are simplified once and the
+// result is copied to the others; an optional MeshCache carries results across batches.
+//
+#pragma once
+#include "mesh.hpp"
+#include "qem.hpp"
+#include <vector>
+
+class ThreadPool;
+class MeshCache;
+
+struct BatchItem {
+    Mesh mesh;               // input, simplified in place
+    SimplifyOptions opt;     // per-mesh options
+    SimplifyReport rep;      // filled by the batch run
+    bool ok = false;         // qem_simplify's return value for this item
+};
+
+// Simplify every item, using `threads` workers (<=0 = all hardware threads).
+// Returns true when every item succeeded. Results found in `cache` skip QEM entirely
+// (rep.from_cache is set); new results are stored in it.
+bool qem_simplify_batch(std::vector<BatchItem>& items, int threads, MeshCache* cache = nullptr);
+
+// Same, on a caller-owned pool (e.g. one kept alive across many batches).
+bool qem_simplify_batch(std::vector<BatchItem>& items, ThreadPool& pool, MeshCache* cache = nullptr);
@@ -0,0 +1,147 @@
+// cli.cpp — Flag parsing and load/simplify/save for a single CliJob.
+
+#include "cli.hpp"
+#include "io_bin.hpp"
+#include "io_obj.hpp"
+#include "mesh_cache.hpp"
+#include "progressive.hpp"
+#include "stream.hpp"
+#include <cstdio>
+
+const char* const kJobFlagsHelp =
+    "--in in.obj --out out.obj [--ratio r|--target-faces n] [--max-collapses n] [--time-limit s]\n"
+    "    [--progress-interval n] [--threads n] [--partitions n] [--deterministic] [--method qem|cluster] [--placement optimal|midpoint|endpoint]\n"
+    "    [--in-format obj|bin] [--out-format obj|bin] [--f32] [--reorder] [--no-guard]\n"
+    "    [--weld eps] [--max-error e|--max-error-rel f] [--boundary-weight w] [--seam-weight w] [--stats json] [--pm-out pm.mqb] [--pm-faces n] [--cache-dir dir]\n"
+    "    [--stream-budget MiB [--stream-tmp dir]]";
+
+static bool parse_format(const std::string& s, MeshFormat& f) {
+    if (s == "obj") f = MeshFormat::Obj; else if (s == "bin") f = MeshFormat::Bin; else return false;
+    return true;
+}
+
+static bool parse_method(const std::string& s, SimplifyMethod& m) {
+    if (s == "qem") m = SimplifyMethod::Qem; else if (s == "cluster") m = SimplifyMethod::Cluster; else return false;
+    return true;
+}
+
+static bool parse_placement(const std::string& s, Placement& p) {
+    if (s == "optimal") p = Placement::Optimal; else if (s == "midpoint") p = Placement::Midpoint; else if (s == "endpoint") p = Placement::Endpoint; else return false;
+    return true;
+}
+
+static MeshFormat resolve_format(MeshFormat f, const std::string& path) {
+    if (f != MeshFormat::Auto) return f;
+    const size_t n = path.size();
+    return (n >= 4 && path.compare(n - 4, 4, ".mqb") == 0) ? MeshFormat::Bin : MeshFormat::Obj;
+}
+
+bool parse_job_args(const std::vector<std::string>& args, CliJob& job, std::string& err) {
+    job = CliJob{};
+    SimplifyOptions& opt = job.opt;
+    const size_t n = args.size();
+    try {
+        for (size_t i = 0; i < n; ++i) {
+            const std::string& a = args[i];
+            const bool has = i + 1 < n;
+            if (a == "--in" && has) job.in_path = args[++i];
+            else if (a == "--out" && has) job.out_path = args[++i];
+            else if (a == "--ratio" && has) opt.ratio = std::stod(args[++i]);
+            else if (a == "--target-faces" && has) opt.target_faces = std::stoi(args[++i]);
+            else if (a == "--max-collapses" && has) opt.max_collapses = std::stoi(args[++i]);
+            else if (a == "--time-limit" && has) opt.time_limit = std::stod(args[++i]);
+            else if (a == "--progress-interval" && has) opt.progress_interval = std::stoi(args[++i]);
+            else if (a == "--threads" && has) opt.threads = std::stoi(args[++i]);
+            else if (a == "--partitions" && has) opt.partitions = std::stoi(args[++i]);
+            else if (a == "--deterministic") opt.deterministic = true;
+            else if (a == "--method" && has && parse_method(args[i + 1], opt.method)) ++i;
+            else if (a == "--placement" && has && parse_placement(args[i + 1], opt.placement)) ++i;
+            else if (a == "--in-format" && has && parse_format(args[i + 1], job.in_fmt)) ++i;
+            else if (a == "--out-format" && has && parse_format(args[i + 1], job.out_fmt)) ++i;
+            else if (a == "--f32") job.f32 = true;
+            else if (a == "--reorder") opt.reorder = true;
+            else if (a == "--no-guard") opt.guard = false;
+            else if (a == "--weld" && has) opt.weld_eps = std::stod(args[++i]);
+            else if (a == "--max-error" && has) { opt.max_error = std::stod(args[++i]); opt.max_error_relative = false; }
+            else if (a == "--max-error-rel" && has) { opt.max_error = std::stod(args[++i]); opt.max_error_relative = true; }
+            else if (a == "--boundary-weight" && has) opt.boundary_weight = std::stod(args[++i]);
+            else if (a == "--seam-weight" && has) opt.seam_weight = std::stod(args[++i]);
+            else if (a == "--stats" && has && args[i + 1] == "json") { job.stats_json = true; opt.collect_stats = true; ++i; }
+            else if (a == "--pm-out" && has) job.pm_out = args[++i];
+            else if (a == "--pm-faces" && has) job.pm_faces = std::stoi(args[++i]);
+            else if (a == "--cache-dir" && has) job.cache_dir = args[++i];
+            else if (a == "--stream-budget" && has) job.stream_budget_mb = (size_t)std::stoull(args[++i]);
+            else if (a == "--stream-tmp" && has) job.stream_tmp = args[++i];
+            else { err = "Unknown or incomplete option: " + a; return false; }
+        }
+    } catch (const std::exception&) {
+        err = "Invalid numeric value in options"; return false;
+    }
+    if (job.in_path.empty() || job.out_path.empty()) { err = "--in and --out are required"; return false; }
+    if (job.stream_budget_mb && (!job.pm_out.empty() || job.pm_faces >= 0 || !job.cache_dir.empty())) {
+        err = "--stream-budget cannot be combined with --pm-out, --pm-faces or --cache-dir"; return false;
+    }
+    return true;
+}
+
+std::string stats_to_json(const SimplifyReport& rep) {
+    const SimplifyStats& s = rep.stats;
+    char buf[1024];
+    std::snprintf(buf, sizeof(buf),
+        "{\"t_weld\":%.6f,\"t_quadrics\":%.6f,\"t_adjacency\":%.6f,\"t_heap_init\":%.6f,\"t_collapse\":%.6f,\"t_compact\":%.6f,\"t_partition\":%.6f,\"t_clusters\":%.6f,\"t_grid\":%.6f,"
+        "\"collapses\":%zu,\"heap_pushes\":%zu,\"stale_pops\":%zu,\"solve_fallbacks\":%zu,\"degenerate_faces\":%zu,\"welded_verts\":%zu,\"boundary_edges\":%zu,\"seam_edges\":%zu,\"flip_rejects\":%zu,\"link_rejects\":%zu,"
+        "\"peak_heap\":%zu,\"clusters\":%zu,\"time_limited\":%s,\"cancelled\":%s,\"error_limited\":%s,\"final_error\":%.9g,\"scratch_bytes\":%zu,\"from_cache\":%s}",
+        s.t_weld, s.t_quadrics, s.t_adjacency, s.t_heap_init, s.t_collapse, s.t_compact, s.t_partition, s.t_clusters, s.t_grid,
+        s.collapses, s.heap_pushes, s.stale_pops, s.solve_fallbacks, s.degenerate_faces, s.welded_verts, s.boundary_edges, s.seam_edges, s.flip_rejects, s.link_rejects,
+        s.peak_heap, s.clusters, s.time_limited ? "true" : "false", s.cancelled ? "true" : "false", s.error_limited ? "true" : "false",
+        rep.final_error, rep.scratch_bytes, rep.from_cache ? "true" : "false");
+    return buf;
+}
+
+int run_job(const CliJob& job, SimplifyReport& rep, std::string& err, SimplifyWorkspace* ws) {
+    Mesh mesh;
+    const MeshFormat in_fmt = resolve_format(job.in_fmt, job.in_path), out_fmt = resolve_format(job.out_fmt, job.out_path);
+    if (job.stream_budget_mb) {
+        // Out-of-core: the input is only ever mapped, the result is built in memory.
+        StreamConfig cfg;
+        cfg.budget_bytes = job.stream_budget_mb << 20;
+        const size_t slash = job.out_path.find_last_of('/');
+        const std::string base = slash == std::string::npos ? job.out_path : job.out_path.substr(slash + 1);
+        cfg.tmp_prefix = job.stream_tmp.empty() ? job.out_path : (job.stream_tmp.back() == '/' ? job.stream_tmp : job.stream_tmp + "/") + base;
+        if (!stream_simplify(job.in_path, in_fmt == MeshFormat::Obj, job.opt, cfg, mesh, rep, err)) { err = "Stream error: " + err; return 4; }
+        if (rep.stats.cancelled) { err = "Cancelled"; return 6; }
+    } else if (job.pm_faces >= 0) {
+        // Level extraction from a stored progressive mesh: no simplification pass.
+        ProgressiveMesh pm;
+        if (in_fmt != MeshFormat::Bin) { err = "Load error: --pm-faces needs an MQB input"; return 3; }
+        if (!load_pm_bin(job.in_path, pm, err)) { err = "Load error: " + err; return 3; }
+        rep = SimplifyReport{};
+        rep.faces_before = pm.base.faces.size(); rep.verts_before = pm.base.verts.size();
+        pm_extract(pm, (size_t)job.pm_faces, mesh);
+        rep.faces_after = mesh.faces.size(); rep.verts_after = mesh.verts.size();
+    } else {
+        bool loaded = in_fmt == MeshFormat::Bin ? load_mesh_bin(job.in_path, mesh, err) : load_obj_tri(job.in_path, mesh, err, job.opt.threads);
+        if (!loaded) { err = "Load error: " + err; return 3; }
+
+        // The disk cache is bypassed when a collapse log is requested: recording it needs the QEM run.
+        const bool use_cache = !job.cache_dir.empty() && job.pm_out.empty();
+        const uint64_t key = use_cache ? mesh_cache_key(mesh, job.opt) : 0;
+        Mesh hit;
+        if (use_cache && disk_cache_load(job.cache_dir, key, hit)) {
+            fill_cached_report(mesh, hit, rep);
+            mesh = std::move(hit);
+        } else {
+            ProgressiveMesh pm;
+            if (!qem_simplify(mesh, job.opt, rep, ws, job.pm_out.empty() ? nullptr : &pm)) { err = "Simplify failed"; return 4; }
+            if (rep.stats.cancelled) { err = "Cancelled"; return 6; }  // nothing is written for a cancelled job
+            if (!job.pm_out.empty() && !save_pm_bin(job.pm_out, pm, err)) { err = "Save error: " + err; return 5; }
+            // A failed cache write only costs the next run a recompute, so it is not an error.
+            std::string cache_err;
+            if (use_cache && cacheable(rep)) disk_cache_store(job.cache_dir, key, mesh, cache_err);
+        }
+    }
+
+    bool saved = out_fmt == MeshFormat::Bin ? save_mesh_bin(job.out_path, mesh, err, job.f32) : save_obj_tri(job.out_path, mesh, err, job.opt.threads);
+    if (!saved) { err = "Save error: " + err; return 5; }
+    return 0;
+}
@@ -0,0 +1,39 @@
+// cli.hpp — Job description shared by the one-shot CLI and the --serve loop.
+//
+// A job is one input/output pair plus SimplifyOptions. parse_job_args() accepts the same
+// flags the command line does (minus process-level ones such as --serve), and run_job()
+// performs load -> simplify -> save, returning the CLI exit code for that job.
+//
+#pragma once
+#include "qem.hpp"
+#include <string>
+#include <vector>
+
+enum class MeshFormat { Auto, Obj, Bin };
+
+struct CliJob {
+    std::string in_path, out_path;
+    MeshFormat in_fmt = MeshFormat::Auto, out_fmt = MeshFormat::Auto; // Auto = by extension (.mqb = binary)
+    bool f32 = false;                 // MQB output with float32 positions
+    bool stats_json = false;          // --stats json: collect SimplifyStats and print them
+    std::string pm_out;               // --pm-out: also save the progressive mesh (MQB)
+    int pm_faces = -1;                // --pm-faces: extract a level from a progressive-mesh input instead of simplifying
+    std::string cache_dir;            // --cache-dir: on-disk result cache keyed by content hash (mesh_cache.hpp)
+    size_t stream_budget_mb = 0;      // --stream-budget: out-of-core run within this many MiB (stream.hpp)
+    std::string stream_tmp;           // --stream-tmp: directory for its temporary files (default: next to --out)
+    SimplifyOptions opt;
+};
+
+// Parse job flags. Returns false with a message in `err` on unknown/incomplete options
+// or when --in/--out is missing.
+bool parse_job_args(const std::vector<std::string>& args, CliJob& job, std::string& err);
+
+// Load, simplify and save one job. Returns 0 on success, otherwise the CLI exit code
+// (3 load, 4 simplify, 5 save, 6 cancelled through job.opt.cancel) with a message in `err`. `ws` is passed to qem_simplify.
+int run_job(const CliJob& job, SimplifyReport& rep, std::string& err, SimplifyWorkspace* ws = nullptr);
+
+// One-line JSON object with the report's scratch bytes and SimplifyStats.
+std::string stats_to_json(const SimplifyReport& rep);
+
+// Flag summary printed by usage() and by --serve on malformed requests.
+extern const char* const kJobFlagsHelp;
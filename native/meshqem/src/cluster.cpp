@@ -0,0 +1,270 @@
+// cluster.cpp — Grid sizing, cell assignment and quadric placement for vertex clustering.
+
+#include "cluster.hpp"
+#include "quadric.hpp"
+#include "parallel.hpp"
+#include "weld.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace {
+
+// Open-addressing map from a cell key to a dense cell index, assigned in insertion order.
+// Sized for `expect` distinct keys at <= 50% load, so an insert never fails.
+class CellTable {
+public:
+    explicit CellTable(size_t expect) {
+        size_t cap = 16; while (cap < expect * 2) cap <<= 1;
+        keys_.assign(cap, kEmpty); ids_.resize(cap); mask_ = cap - 1;
+    }
+    int find_or_add(uint64_t key) {
+        for (size_t i = mix(key) & mask_;; i = (i + 1) & mask_) {
+            if (keys_[i] == key) return ids_[i];
+            if (keys_[i] == kEmpty) { keys_[i] = key; return ids_[i] = count_++; }
+        }
+    }
+    int size() const { return count_; }
+    size_t bytes() const { return keys_.capacity() * sizeof(uint64_t) + ids_.capacity() * sizeof(int); }
+    static uint64_t mix(uint64_t k) { k ^= k >> 33; k *= 0xff51afd7ed558ccdULL; k ^= k >> 33; return k; }
+
+private:
+    static constexpr uint64_t kEmpty = ~(uint64_t)0;
+    std::vector<uint64_t> keys_;
+    std::vector<int> ids_;
+    size_t mask_ = 0;
+    int count_ = 0;
+};
+
+// Uniform grid over the bounding box; at most 2^21 cells per axis so a key fits 63 bits.
+struct Grid {
+    double lo[3], h, inv;
+    Grid(const double blo[3], const double bhi[3], double cell) {
+        double ext = 0; for (int k = 0; k < 3; ++k) { lo[k] = blo[k]; ext = std::max(ext, bhi[k] - blo[k]); }
+        h = std::max(cell, ext / (double)((1 << 21) - 1));
+        if (!(h > 0)) h = 1.0;
+        inv = 1.0 / h;
+    }
+    uint32_t coord(double x, int k) const { return (uint32_t)std::min((double)((1 << 21) - 1), std::max(0.0, (x - lo[k]) * inv)); }
+    template <class V> uint64_t key(const V& p) const {
+        return (uint64_t)coord(p.x, 0) | (uint64_t)coord(p.y, 1) << 21 | (uint64_t)coord(p.z, 2) << 42;
+    }
+};
+
+// Faces keyed by their corner cells, rotated so the smallest comes first (orientation kept:
+// the two sides of a thin sheet stay separate faces). Sized for `expect` distinct faces.
+class FaceSet {
+public:
+    explicit FaceSet(size_t expect) {
+        size_t cap = 16; while (cap < expect * 2) cap <<= 1;
+        slots_.assign(cap, -1); mask_ = cap - 1;
+    }
+    // True when `t` was not present yet; it is then appended to `faces`.
+    bool insert(const Tri& t, std::vector<Tri>& faces) {
+        const uint64_t h = CellTable::mix(((uint64_t)(uint32_t)t.a * 0x9E3779B97F4A7C15ULL) ^ ((uint64_t)(uint32_t)t.b << 21) ^ ((uint64_t)(uint32_t)t.c << 42));
+        for (size_t i = h & mask_;; i = (i + 1) & mask_) {
+            const int s = slots_[i];
+            if (s < 0) { slots_[i] = (int)faces.size(); faces.push_back(t); return true; }
+            const Tri& o = faces[(size_t)s];
+            if (o.a == t.a && o.b == t.b && o.c == t.c) return false;
+        }
+    }
+
+private:
+    std::vector<int> slots_;
+    size_t mask_ = 0;
+};
+
+} // namespace
+
+template <class T>
+void cluster_simplify(MeshT<T>& mesh, const SimplifyOptions& opt, SimplifyReport& rep) {
+    using clock = std::chrono::steady_clock;
+    clock::time_point t = clock::now();
+    auto lap = [&](double& slot) { if (!opt.collect_stats) return; clock::time_point n = clock::now(); slot += std::chrono::duration<double>(n - t).count(); t = n; };
+    rep = SimplifyReport{};
+    rep.faces_before = mesh.faces.size();
+    rep.verts_before = mesh.verts.size();
+    SimplifyStats& st = rep.stats;
+    if (opt.weld_eps >= 0) { st.welded_verts = weld_vertices(mesh, opt.weld_eps, opt.threads); lap(st.t_weld); }
+
+    const size_t nf = mesh.faces.size(), nv = mesh.verts.size();
+    const int threads = resolve_threads(opt.threads);
+    const int target = opt.target_faces > 0 ? opt.target_faces : (int)std::max(0.0, std::floor((double)nf * std::min(1.0, std::max(0.0, opt.ratio))));
+    if (nf == 0 || (size_t)target >= nf) { rep.faces_after = nf; rep.verts_after = nv; return; }
+
+    // Referenced vertices and their bounding box; total area sizes the first grid.
+    std::vector<char> used(nv, 0);
+    for (const Tri& f : mesh.faces) { used[f.a] = used[f.b] = used[f.c] = 1; }
+    double blo[3] = {HUGE_VAL, HUGE_VAL, HUGE_VAL}, bhi[3] = {-HUGE_VAL, -HUGE_VAL, -HUGE_VAL};
+    size_t nused = 0;
+    for (size_t i = 0; i < nv; ++i) {
+        if (!used[i]) continue;
+        const double p[3] = {mesh.verts[i].x, mesh.verts[i].y, mesh.verts[i].z};
+        for (int k = 0; k < 3; ++k) { blo[k] = std::min(blo[k], p[k]); bhi[k] = std::max(bhi[k], p[k]); }
+        nused++;
+    }
+    // Summed in fixed blocks so the total (and with it the grid) is the same for any thread count.
+    const size_t block = 65536, nblocks = (nf + block - 1) / block;
+    std::vector<double> area_part(nblocks, 0.0);
+    parallel_for(nblocks, threads, [&](size_t b0, size_t e0, int) { for (size_t k = b0; k < e0; ++k) {
+        double s = 0;
+        for (size_t fi = k * block, e = std::min(nf, fi + block); fi < e; ++fi) {
+            const Tri& f = mesh.faces[fi]; const auto &p = mesh.verts[f.a], &q = mesh.verts[f.b], &r = mesh.verts[f.c];
+            const double ux = q.x-p.x, uy = q.y-p.y, uz = q.z-p.z, vx = r.x-p.x, vy = r.y-p.y, vz = r.z-p.z;
+            const double nx = uy*vz-uz*vy, ny = uz*vx-ux*vz, nz = ux*vy-uy*vx;
+            s += 0.5 * std::sqrt(nx*nx + ny*ny + nz*nz);
+        }
+        area_part[k] = s;
+    } }, 1);
+    double area = 0; for (double a : area_part) area += a;
+
+    // Grid sizing. A surface with area A occupies about A/h^2 cells, and clustered meshes
+    // have a roughly fixed number of faces per occupied cell (about 2 on clean manifolds,
+    // more where clusters meet at odd angles). The first guess assumes 2; its measured face
+    // and cell counts then give the real ratio and the cell target, and two more occupancy
+    // passes (first assuming occ ~ h^-2, then with the measured slope) home in on it.
+    std::vector<uint64_t> keys(nv);
+    std::vector<int> cid(nv, -1);
+    size_t tab_bytes = 0;
+    auto assign = [&](const Grid& g) {
+        parallel_for(nv, threads, [&](size_t b, size_t e, int) { for (size_t i = b; i < e; ++i) keys[i] = g.key(mesh.verts[i]); });
+        CellTable tab(nused);
+        for (size_t i = 0; i < nv; ++i) if (used[i]) cid[i] = tab.find_or_add(keys[i]);
+        tab_bytes = tab.bytes();
+        return (double)tab.size();
+    };
+    auto canonical = [&](const Tri& f, Tri& t) {
+        t = Tri{cid[f.a], cid[f.b], cid[f.c]};
+        if (t.a == t.b || t.b == t.c || t.a == t.c) return false;
+        while (t.a > t.b || t.a > t.c) t = Tri{t.b, t.c, t.a};
+        return true;
+    };
+    double h = area > 0 ? std::sqrt(area / std::max(1.0, target * 0.5)) : 1.0;
+    const double occ0 = assign(Grid(blo, bhi, h));
+    double faces0 = 0;
+    {
+        std::vector<Tri> tmp; FaceSet seen(nf); Tri ct;
+        for (const Tri& f : mesh.faces) if (canonical(f, ct)) seen.insert(ct, tmp);
+        faces0 = (double)tmp.size();
+    }
+    const double want = std::max(1.0, target / std::max(1.0, faces0 / std::max(1.0, occ0)));
+    if (occ0 != want) {
+        const double h0 = h;
+        h = h0 * std::sqrt(occ0 / want);
+        const double occ1 = assign(Grid(blo, bhi, h));
+        double slope = 2.0;
+        if (occ1 > 0 && occ1 != occ0 && h != h0) slope = std::min(3.0, std::max(0.5, std::log(occ0 / occ1) / std::log(h / h0)));
+        if (occ1 > 0) h *= std::pow(occ1 / want, 1.0 / slope);
+    }
+
+    // Final assignment, in vertex order.
+    const Grid grid(blo, bhi, h);
+    const size_t ncell = (size_t)assign(grid);
+    size_t scratch = keys.capacity() * sizeof(uint64_t) + cid.capacity() * sizeof(int) + used.capacity() + tab_bytes;
+    std::vector<uint64_t>().swap(keys);
+    lap(st.t_grid);
+
+    // Cell quadrics: each face's area-weighted plane, added once per corner in that cell,
+    // i.e. the sum of the member vertices' quadrics. Faces are bucketed by cell (counting
+    // sort, face order kept) with the corner multiplicity packed into the low 2 bits, so a
+    // face inside one cell is visited once; each cell then sums its own bucket, which is
+    // cell-parallel, race-free and identical for any thread count.
+    std::vector<size_t> cstart(ncell + 1, 0);
+    auto corner_cells = [&](const Tri& f, int c[3], int m[3]) {
+        int n = 0; for (int x : {cid[f.a], cid[f.b], cid[f.c]}) { int k = 0; while (k < n && c[k] != x) ++k; if (k == n) { c[n] = x; m[n++] = 1; } else m[k]++; }
+        return n;
+    };
+    for (const Tri& f : mesh.faces) { int c[3], m[3]; for (int k = 0, n = corner_cells(f, c, m); k < n; ++k) cstart[(size_t)c[k] + 1]++; }
+    for (size_t c = 0; c < ncell; ++c) cstart[c + 1] += cstart[c];
+    std::vector<uint64_t> cface(cstart[ncell]);  // (face << 2) | multiplicity
+    {
+        std::vector<size_t> pos(cstart.begin(), cstart.end() - 1);
+        for (size_t fi = 0; fi < nf; ++fi) { int c[3], m[3]; for (int k = 0, n = corner_cells(mesh.faces[fi], c, m); k < n; ++k) cface[pos[(size_t)c[k]]++] = (uint64_t)fi << 2 | (uint64_t)m[k]; }
+    }
+    std::vector<Quadric> cq(ncell);
+    parallel_for(ncell, threads, [&](size_t b, size_t e, int) {
+        for (size_t c = b; c < e; ++c) {
+            Quadric& Q = cq[c]; q_zero(Q);
+            for (size_t k = cstart[c]; k < cstart[c + 1]; ++k) {
+                const Tri& f = mesh.faces[cface[k] >> 2]; const auto &p = mesh.verts[f.a], &q = mesh.verts[f.b], &r = mesh.verts[f.c];
+                const double ux = q.x-p.x, uy = q.y-p.y, uz = q.z-p.z, vx = r.x-p.x, vy = r.y-p.y, vz = r.z-p.z;
+                double nx = uy*vz-uz*vy, ny = uz*vx-ux*vz, nz = ux*vy-uy*vx;
+                const double L = std::sqrt(nx*nx + ny*ny + nz*nz);
+                if (L < 1e-12) continue;
+                // unit plane scaled by sqrt(area * multiplicity): the outer product carries the weight
+                const double s = std::sqrt(0.5 * L * (double)(cface[k] & 3u)) / L;
+                nx *= s; ny *= s; nz *= s;
+                q_add(Q, plane_quadric(nx, ny, nz, -(nx*p.x + ny*p.y + nz*p.z)));
+            }
+        }
+    });
+    scratch += cstart.capacity() * sizeof(size_t) + cface.capacity() * sizeof(uint64_t) + cq.capacity() * sizeof(Quadric);
+    std::vector<uint64_t>().swap(cface);
+
+    // Representatives: quadric minimizer, or the cell's vertex mean when the system is
+    // singular or the minimizer leaves the cell (grown by half a cell on each side).
+    std::vector<Vec3> mean(ncell);
+    std::vector<int> cnt(ncell, 0);
+    for (size_t i = 0; i < nv; ++i) {
+        if (cid[i] < 0) continue;
+        Vec3& m = mean[(size_t)cid[i]]; m.x += mesh.verts[i].x; m.y += mesh.verts[i].y; m.z += mesh.verts[i].z; cnt[(size_t)cid[i]]++;
+    }
+    std::vector<Vec3> rep_pos(ncell);
+    std::vector<size_t> fb((size_t)parallel_chunks(ncell, threads), 0);
+    parallel_for(ncell, threads, [&](size_t b, size_t e, int c) {
+        for (size_t i = b; i < e; ++i) {
+            const double k = 1.0 / cnt[i];
+            const Vec3 m{mean[i].x * k, mean[i].y * k, mean[i].z * k};
+            double A[9], B[3], x[3];
+            quadric_system(cq[i], A, B);
+            bool ok = solve3(A, B, x);
+            if (ok) {
+                const Vec3 pc{x[0], x[1], x[2]};
+                const double lo[3] = {std::floor((m.x - grid.lo[0]) * grid.inv), std::floor((m.y - grid.lo[1]) * grid.inv), std::floor((m.z - grid.lo[2]) * grid.inv)};
+                const double px[3] = {(pc.x - grid.lo[0]) * grid.inv, (pc.y - grid.lo[1]) * grid.inv, (pc.z - grid.lo[2]) * grid.inv};
+                for (int a = 0; a < 3; ++a) ok = ok && px[a] >= lo[a] - 0.5 && px[a] <= lo[a] + 1.5;
+                if (ok) { rep_pos[i] = pc; continue; }
+            }
+            fb[(size_t)c]++;
+            rep_pos[i] = m;
+        }
+    });
+    for (size_t x : fb) st.solve_fallbacks += x;
+    scratch += mean.capacity() * sizeof(Vec3) + cnt.capacity() * sizeof(int) + rep_pos.capacity() * sizeof(Vec3);
+    lap(st.t_quadrics);
+
+    // Faces: corners mapped to cells; collapsed and repeated faces dropped, UVs and ids kept
+    // with the first copy; then cells still referenced are compacted in cell order.
+    std::vector<Tri> faces;
+    std::vector<std::array<T, 6>> uvs;
+    std::vector<int> ids;
+    const bool has_uv = mesh.face_uvs.size() == nf, has_id = mesh.face_ids.size() == nf;
+    FaceSet seen(nf);
+    Tri ct;
+    for (size_t fi = 0; fi < nf; ++fi) {
+        if (!canonical(mesh.faces[fi], ct) || !seen.insert(ct, faces)) continue;
+        if (has_uv) uvs.push_back(mesh.face_uvs[fi]);
+        if (has_id) ids.push_back(mesh.face_ids[fi]);
+    }
+    std::vector<int> remap(ncell, -1);
+    std::vector<Vec3T<T>> verts;
+    for (const Tri& f : faces) for (int c : {f.a, f.b, f.c}) if (remap[(size_t)c] < 0) remap[(size_t)c] = 0;
+    for (size_t c = 0; c < ncell; ++c) if (remap[c] == 0) { remap[c] = (int)verts.size(); const Vec3& r = rep_pos[c]; verts.push_back(Vec3T<T>{(T)r.x, (T)r.y, (T)r.z}); }
+    for (Tri& f : faces) f = Tri{remap[(size_t)f.a], remap[(size_t)f.b], remap[(size_t)f.c]};
+    mesh.verts.swap(verts);
+    mesh.faces.swap(faces);
+    mesh.face_uvs.swap(uvs);
+    if (!has_uv) mesh.face_uvs.clear();
+    mesh.face_ids.swap(ids);
+    if (!has_id) mesh.face_ids.clear();
+    rep.faces_after = mesh.faces.size();
+    rep.verts_after = mesh.verts.size();
+    rep.scratch_bytes = scratch;
+    lap(st.t_compact);
+}
+
+template void cluster_simplify(Mesh&, const SimplifyOptions&, SimplifyReport&);
+template void cluster_simplify(MeshF&, const SimplifyOptions&, SimplifyReport&);
@@ -0,0 +1,26 @@
+// cluster.hpp — Uniform-grid vertex clustering: a fast, approximate alternative to QEM.
+//
+// Selected with SimplifyOptions::method = SimplifyMethod::Cluster (CLI: --method cluster) and
+// meant for previews: distant proxies, thumbnails. All vertices in one grid cell merge into
+// a single representative placed at the minimizer of the cell's summed, area-weighted face
+// quadrics (the cell's vertex mean when that system is singular or its solution leaves the
+// cell). Faces whose corners land in fewer than three cells disappear, as do duplicates.
+//
+// - The cell size is chosen from the total surface area so that about target/2 cells are
+//   occupied (F ~ 2V on a surface), then corrected twice from measured occupancy; the face
+//   count therefore lands near, not exactly on, the target.
+// - Every pass is linear in the mesh size. Quadrics are summed per cell over faces bucketed
+//   by cell, and the cell table is filled in vertex order, so the output does not depend on
+//   the thread count.
+// - Same Mesh contract as qem_simplify: in place, face_uvs/face_ids carried with surviving faces,
+//   vertices compacted in order of first use by a cell.
+//
+#pragma once
+#include "mesh.hpp"
+#include "qem.hpp"
+
+// Cluster `mesh` in place toward opt's target (ratio / target_faces); honours weld_eps and
+// threads, ignores the collapse-loop options. Fills rep like qem_simplify. Instantiated for
+// Mesh and MeshF; cell quadrics and representatives are computed in double either way.
+template <class T>
+void cluster_simplify(MeshT<T>& mesh, const SimplifyOptions& opt, SimplifyReport& rep);
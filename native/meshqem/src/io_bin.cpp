@@ -0,0 +1,204 @@
+// io_bin.cpp — Reader/writer for the MQB binary mesh format (see io_bin.hpp).
+
+#include "io_bin.hpp"
+#include "mapped_file.hpp"
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+static const char kMagic[8] = {'M','E','S','H','Q','E','M','B'};
+
+static_assert(sizeof(Vec3) == 3 * sizeof(double), "Vec3 must be 3 packed doubles");
+static_assert(sizeof(Tri) == 3 * sizeof(int32_t), "Tri must be 3 packed int32");
+static_assert(offsetof(MeshBinHeader, log_offset) == 56, "MQB header layout changed");
+
+static inline bool host_is_little_endian() { const uint32_t one = 1; unsigned char b; std::memcpy(&b, &one, 1); return b == 1; }
+static inline uint64_t align64(uint64_t x) { return (x + 63) & ~(uint64_t)63; }
+
+bool open_mesh_bin(const MappedFile& file, MeshBinView& view, std::string& err) {
+    if (!host_is_little_endian()) { err = "MQB: big-endian hosts are not supported"; return false; }
+    if (file.size() < sizeof(MeshBinHeader)) { err = "MQB: file too small"; return false; }
+    const auto* h = reinterpret_cast<const MeshBinHeader*>(file.data());
+    if (std::memcmp(h->magic, kMagic, 8) != 0) { err = "MQB: bad magic"; return false; }
+    if (h->version != MQB_VERSION) { err = "MQB: unsupported version " + std::to_string(h->version); return false; }
+
+    // Every array must lie inside the file; sizes are checked without overflow.
+    const uint64_t size = file.size();
+    auto fits = [size](uint64_t off, uint64_t count, uint64_t elem) {
+        return off >= sizeof(MeshBinHeader) && off <= size && off % 8 == 0 && (count == 0 || count <= (size - off) / elem);
+    };
+    const uint64_t vsz = (h->flags & MQB_F32_POSITIONS) ? 3 * sizeof(float) : 3 * sizeof(double);
+    if (!fits(h->verts_offset, h->num_verts, vsz)) { err = "MQB: vertex array out of bounds"; return false; }
+    if (!fits(h->faces_offset, h->num_faces, 3 * sizeof(int32_t))) { err = "MQB: face array out of bounds"; return false; }
+    if ((h->flags & MQB_HAS_UVS) && !fits(h->uvs_offset, h->num_faces, 6 * sizeof(double))) { err = "MQB: uv array out of bounds"; return false; }
+    if ((h->flags & MQB_HAS_PM_LOG) && !fits(h->log_offset, h->log_count, sizeof(CollapseRecord))) { err = "MQB: collapse log out of bounds"; return false; }
+    if (h->num_verts > (uint64_t)INT32_MAX || h->num_faces > (uint64_t)INT32_MAX) { err = "MQB: mesh too large"; return false; }
+
+    view = MeshBinView{};
+    view.header = h;
+    if (h->flags & MQB_F32_POSITIONS) view.verts_f32 = reinterpret_cast<const float*>(file.data() + h->verts_offset);
+    else view.verts_f64 = reinterpret_cast<const double*>(file.data() + h->verts_offset);
+    view.faces = reinterpret_cast<const int32_t*>(file.data() + h->faces_offset);
+    if (h->flags & MQB_HAS_UVS) view.uvs = reinterpret_cast<const double*>(file.data() + h->uvs_offset);
+    if (h->flags & MQB_HAS_PM_LOG) {
+        view.log = reinterpret_cast<const CollapseRecord*>(file.data() + h->log_offset);
+        view.log_count = (size_t)h->log_count;
+    }
+    return true;
+}
+
+// Copy the mesh arrays of a validated view into `mesh`.
+static bool copy_view(const MeshBinView& view, const std::string& path, Mesh& mesh, std::string& err) {
+    const size_t nv = (size_t)view.header->num_verts, nf = (size_t)view.header->num_faces;
+
+    mesh.verts.resize(nv);
+    if (view.verts_f64) std::memcpy(mesh.verts.data(), view.verts_f64, nv * sizeof(Vec3));
+    else for (size_t i = 0; i < nv; ++i) mesh.verts[i] = {view.verts_f32[3*i], view.verts_f32[3*i+1], view.verts_f32[3*i+2]};
+    mesh.faces.resize(nf);
+    std::memcpy(mesh.faces.data(), view.faces, nf * sizeof(Tri));
+    if (view.uvs) {
+        mesh.face_uvs.resize(nf);
+        std::memcpy(mesh.face_uvs.data(), view.uvs, nf * sizeof(mesh.face_uvs[0]));
+    }
+    // Same guarantees as the OBJ loader: non-empty and every index in range.
+    if (nv == 0 || nf == 0) { err = "empty mesh from: " + path; mesh.clear(); return false; }
+    for (const auto& f : mesh.faces) {
+        if ((unsigned)f.a >= nv || (unsigned)f.b >= nv || (unsigned)f.c >= nv) { err = "MQB: face index out of range in: " + path; mesh.clear(); return false; }
+    }
+    return true;
+}
+
+bool load_mesh_bin(const std::string& path, Mesh& mesh, std::string& err) {
+    mesh.clear();
+    MappedFile file;
+    if (!file.open(path, err)) return false;
+    MeshBinView view;
+    if (!open_mesh_bin(file, view, err)) { err += " in: " + path; return false; }
+    return copy_view(view, path, mesh, err);
+}
+
+bool load_pm_bin(const std::string& path, ProgressiveMesh& pm, std::string& err) {
+    pm.base.clear(); pm.log.clear();
+    MappedFile file;
+    if (!file.open(path, err)) return false;
+    MeshBinView view;
+    if (!open_mesh_bin(file, view, err)) { err += " in: " + path; return false; }
+    if (!copy_view(view, path, pm.base, err)) return false;
+    pm.log.assign(view.log, view.log + view.log_count);
+    // Replay indexes the base mesh directly, so every record is range-checked once here.
+    const size_t nv = pm.base.verts.size();
+    for (const auto& r : pm.log) {
+        if ((unsigned)r.u >= nv || (unsigned)r.v >= nv) { err = "MQB: collapse record out of range in: " + path; pm.base.clear(); pm.log.clear(); return false; }
+    }
+    return true;
+}
+
+// Shared writer: the mesh arrays, then the collapse log when `log_count` > 0.
+static bool write_bin(const std::string& path, const Mesh& mesh, const CollapseRecord* log, size_t log_count,
+                      std::string& err, bool f32_positions) {
+    if (!host_is_little_endian()) { err = "MQB: big-endian hosts are not supported"; return false; }
+    const bool has_uv = !mesh.face_uvs.empty() && mesh.face_uvs.size() == mesh.faces.size();
+    MeshBinHeader h{};
+    std::memcpy(h.magic, kMagic, 8);
+    h.version = MQB_VERSION;
+    h.flags = (f32_positions ? MQB_F32_POSITIONS : 0u) | (has_uv ? MQB_HAS_UVS : 0u) | (log_count ? MQB_HAS_PM_LOG : 0u);
+    h.num_verts = mesh.verts.size();
+    h.num_faces = mesh.faces.size();
+    const uint64_t vbytes = h.num_verts * (f32_positions ? 3 * sizeof(float) : 3 * sizeof(double));
+    const uint64_t fbytes = h.num_faces * sizeof(Tri);
+    h.verts_offset = align64(sizeof(MeshBinHeader));
+    h.faces_offset = align64(h.verts_offset + vbytes);
+    h.uvs_offset = has_uv ? align64(h.faces_offset + fbytes) : 0;
+    const uint64_t uend = has_uv ? h.uvs_offset + h.num_faces * sizeof(mesh.face_uvs[0]) : h.faces_offset + fbytes;
+    h.log_offset = log_count ? align64(uend) : 0;
+    h.log_count = log_count;
+
+    std::FILE* out = std::fopen(path.c_str(), "wb");
+    if (!out) { err = "cannot write: " + path; return false; }
+    uint64_t pos = 0;
+    auto put = [&](const void* p, uint64_t n) { if (n && std::fwrite(p, 1, (size_t)n, out) != n) return false; pos += n; return true; };
+    auto pad_to = [&](uint64_t off) { static const char zeros[64] = {}; return put(zeros, off - pos); };
+
+    bool ok = put(&h, sizeof(h)) && pad_to(h.verts_offset);
+    if (ok && f32_positions) {
+        std::vector<float> tmp;
+        const size_t block = (size_t)1 << 16;
+        for (size_t i0 = 0; ok && i0 < mesh.verts.size(); i0 += block) {
+            const size_t i1 = std::min(mesh.verts.size(), i0 + block);
+            tmp.resize((i1 - i0) * 3);
+            for (size_t i = i0; i < i1; ++i) { const Vec3& v = mesh.verts[i]; float* t = &tmp[(i - i0) * 3]; t[0] = (float)v.x; t[1] = (float)v.y; t[2] = (float)v.z; }
+            ok = put(tmp.data(), tmp.size() * sizeof(float));
+        }
+    } else if (ok) {
+        ok = put(mesh.verts.data(), vbytes);
+    }
+    ok = ok && pad_to(h.faces_offset) && put(mesh.faces.data(), fbytes);
+    if (has_uv) ok = ok && pad_to(h.uvs_offset) && put(mesh.face_uvs.data(), h.num_faces * sizeof(mesh.face_uvs[0]));
+    if (log_count) ok = ok && pad_to(h.log_offset) && put(log, log_count * sizeof(CollapseRecord));
+    ok = (std::fclose(out) == 0) && ok;
+    if (!ok) { err = "write failed: " + path; return false; }
+    return true;
+}
+
+// ---- MeshBinWriter ----
+// One FILE*, with a cursor per section; each append seeks to its section's cursor, so
+// interleaved appends cost a seek (and a buffer flush) each, not a rewrite.
+static bool seek64(std::FILE* f, uint64_t off) {
+#if defined(_WIN32)
+    return _fseeki64(f, (long long)off, SEEK_SET) == 0;
+#else
+    return fseeko(f, (off_t)off, SEEK_SET) == 0;
+#endif
+}
+
+MeshBinWriter::~MeshBinWriter() { if (out_) std::fclose(out_); }
+
+bool MeshBinWriter::open(const std::string& path, size_t num_verts, size_t num_faces, std::string& err) {
+    if (!host_is_little_endian()) { err = "MQB: big-endian hosts are not supported"; return false; }
+    if (num_verts > (size_t)INT32_MAX || num_faces > (size_t)INT32_MAX) { err = "MQB: mesh too large"; return false; }
+    MeshBinHeader h{};
+    std::memcpy(h.magic, kMagic, 8);
+    h.version = MQB_VERSION;
+    h.num_verts = num_verts; h.num_faces = num_faces;
+    h.verts_offset = align64(sizeof(MeshBinHeader));
+    h.faces_offset = align64(h.verts_offset + h.num_verts * sizeof(Vec3));
+    out_ = std::fopen(path.c_str(), "wb");
+    if (!out_) { err = "cannot write: " + path; return false; }
+    path_ = path;
+    vpos_ = h.verts_offset; vend_ = vpos_ + h.num_verts * sizeof(Vec3);
+    fpos_ = h.faces_offset; fend_ = fpos_ + h.num_faces * sizeof(Tri);
+    static const char zeros[64] = {};
+    ok_ = std::fwrite(&h, sizeof(h), 1, out_) == 1 && std::fwrite(zeros, 1, (size_t)(h.verts_offset - sizeof(h)), out_) == h.verts_offset - sizeof(h);
+    if (!ok_) { err = "write failed: " + path; return false; }
+    return true;
+}
+
+bool MeshBinWriter::put_at(uint64_t& pos, uint64_t end, const void* p, uint64_t n) {
+    if (!ok_ || !out_ || n > end - pos) return ok_ = false;
+    if (n && (!seek64(out_, pos) || std::fwrite(p, 1, (size_t)n, out_) != n)) return ok_ = false;
+    pos += n;
+    return true;
+}
+
+bool MeshBinWriter::append_verts(const Vec3* v, size_t n) { return put_at(vpos_, vend_, v, n * sizeof(Vec3)); }
+bool MeshBinWriter::append_faces(const Tri* f, size_t n) { return put_at(fpos_, fend_, f, n * sizeof(Tri)); }
+
+bool MeshBinWriter::close(std::string& err) {
+    if (!out_) { err = "MQB writer not open"; return false; }
+    // Seeking past the end and writing zero-fills the gap, so the padding needs no writes.
+    const bool complete = vpos_ == vend_ && fpos_ == fend_;
+    const bool ok = (std::fclose(out_) == 0) && ok_;
+    out_ = nullptr;
+    if (!ok) { err = "write failed: " + path_; return false; }
+    if (!complete) { err = "MQB: fewer records written than announced: " + path_; return false; }
+    return true;
+}
+
+bool save_mesh_bin(const std::string& path, const Mesh& mesh, std::string& err, bool f32_positions) {
+    return write_bin(path, mesh, nullptr, 0, err, f32_positions);
+}
+
+bool save_pm_bin(const std::string& path, const ProgressiveMesh& pm, std::string& err) {
+    return write_bin(path, pm.base, pm.log.data(), pm.log.size(), err, false);
+}
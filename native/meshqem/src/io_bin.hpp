@@ -0,0 +1,94 @@
+// io_bin.hpp — Compact binary mesh interchange format ("MQB") for meshqem.
+//
+// Layout (all little-endian, every array starts on a 64-byte boundary):
+//
+//     MeshBinHeader              128 bytes, see below
+//     verts   num_verts x 3      float64, or float32 when MQB_F32_POSITIONS is set
+//     faces   num_faces x 3      int32, 0-based vertex indices
+//     uvs     num_faces x 6      float64 (u0,v0,u1,v1,u2,v2) per face, when MQB_HAS_UVS is set
+//     log     log_count x 40 B   CollapseRecord per collapse, when MQB_HAS_PM_LOG is set
+//
+// Unlike OBJ the format carries Mesh::face_uvs, and it needs no parsing: a reader maps the
+// file once and either uses the arrays in place (MeshBinView) or copies them into a Mesh
+// with one memcpy per array. Conventional extension: .mqb
+// A file with a collapse log is a progressive mesh: the arrays hold its base mesh.
+//
+#pragma once
+#include "mesh.hpp"
+#include "progressive.hpp"
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+class MappedFile;
+
+constexpr uint32_t MQB_VERSION = 1;
+constexpr uint32_t MQB_F32_POSITIONS = 1u << 0; // verts stored as float32 instead of float64
+constexpr uint32_t MQB_HAS_UVS       = 1u << 1; // per-face UV triplets present
+constexpr uint32_t MQB_HAS_PM_LOG    = 1u << 2; // progressive-mesh collapse log present
+
+struct MeshBinHeader {
+    char     magic[8];       // "MESHQEMB"
+    uint32_t version;        // MQB_VERSION
+    uint32_t flags;          // MQB_* bits
+    uint64_t num_verts;
+    uint64_t num_faces;
+    uint64_t verts_offset;   // byte offsets from the start of the file
+    uint64_t faces_offset;
+    uint64_t uvs_offset;     // 0 when MQB_HAS_UVS is not set
+    uint64_t log_offset;     // 0 when MQB_HAS_PM_LOG is not set
+    uint64_t log_count;      // number of CollapseRecords
+    uint64_t reserved[7];    // zero; room for future sections
+};
+static_assert(sizeof(MeshBinHeader) == 128, "MeshBinHeader must stay 128 bytes");
+
+// Zero-copy view into a mapped MQB file; pointers stay valid while the MappedFile is open.
+struct MeshBinView {
+    const MeshBinHeader* header = nullptr;
+    const double*  verts_f64 = nullptr;  // set unless MQB_F32_POSITIONS
+    const float*   verts_f32 = nullptr;  // set when MQB_F32_POSITIONS
+    const int32_t* faces = nullptr;      // num_faces x 3
+    const double*  uvs = nullptr;        // num_faces x 6, or nullptr
+    const CollapseRecord* log = nullptr; // log_count records, or nullptr
+    size_t log_count = 0;
+};
+
+// Validate the header and array bounds of an opened file and fill `view`.
+bool open_mesh_bin(const MappedFile& file, MeshBinView& view, std::string& err);
+
+// Load an MQB file into `mesh` (positions widened to double if stored as float32).
+// On failure, returns false and writes a human-readable message to `err`.
+bool load_mesh_bin(const std::string& path, Mesh& mesh, std::string& err);
+
+// Save `mesh` (including face_uvs when aligned with faces) as MQB.
+// `f32_positions` stores vertex positions as float32 to halve their size.
+bool save_mesh_bin(const std::string& path, const Mesh& mesh, std::string& err, bool f32_positions = false);
+
+// Incremental writer for meshes that never exist in memory as a whole (io_obj.hpp's
+// convert_obj_to_bin, stream.hpp): the counts are fixed by open(), then vertices and faces
+// are appended in order, possibly interleaved, in pieces of any size. float64 positions,
+// no UVs or log. close() fails unless exactly the announced counts were written.
+class MeshBinWriter {
+public:
+    MeshBinWriter() = default;
+    ~MeshBinWriter();
+    MeshBinWriter(const MeshBinWriter&) = delete;
+    MeshBinWriter& operator=(const MeshBinWriter&) = delete;
+
+    bool open(const std::string& path, size_t num_verts, size_t num_faces, std::string& err);
+    bool append_verts(const Vec3* v, size_t n);
+    bool append_faces(const Tri* f, size_t n);
+    bool close(std::string& err);
+
+private:
+    bool put_at(uint64_t& pos, uint64_t end, const void* p, uint64_t n);
+    std::FILE* out_ = nullptr;
+    std::string path_;
+    uint64_t vpos_ = 0, vend_ = 0, fpos_ = 0, fend_ = 0;  // write cursors and section ends
+    bool ok_ = true;
+};
+
+// Progressive meshes: the base mesh (always float64, so replay stays exact) plus the log.
+// load_pm_bin also accepts a plain MQB file, which yields an empty log.
+bool save_pm_bin(const std::string& path, const ProgressiveMesh& pm, std::string& err);
+bool load_pm_bin(const std::string& path, ProgressiveMesh& pm, std::string& err);
@@ -1,63 +1,271 @@
-// io_obj.cpp — Tiny triangle-only OBJ reader/writer used as an interchange format
+// io_obj.cpp — Triangle-only OBJ reader/writer used as an interchange format
 // between the Python USD bridge and the native QEM kernel. We deliberately keep
-// this parser tiny (no dependencies) and robust enough for well-formed files that
-// our own exporter writes.
+// it dependency-free; both directions are tuned for large files (mmap + exact reserve +
+// parallel chunks when reading, block-buffered to_chars formatting when writing) since on
+// big intermediates text I/O used to dominate runtime.
 
 #include "io_obj.hpp"
-#include <fstream>
-#include <sstream>
+#include "io_bin.hpp"
+#include "mapped_file.hpp"
+#include "parallel.hpp"
+#include <algorithm>
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
 
-// Trim trailing whitespace (incl. CR/LF). OBJ is line-oriented so this is sufficient
-// to normalize lines before tokenizing with stringstreams.
-static inline void trim(std::string& s) {
-    while (!s.empty() && (s.back()=='\n' || s.back()=='\r' || s.back()==' ' || s.back()=='\t')) s.pop_back();
+// ---- loader --------------------------------------------------------------------------
+// The file is memory-mapped and parsed in place: records are classified by their first
+// character, numbers are read with std::from_chars (locale-free, no temporaries).
+// Two passes over the bytes: the first counts v/f records so the arrays are sized exactly
+// once, the second fills them. Both passes run over line-aligned chunks in parallel; the
+// per-chunk vertex counts from pass one give every chunk its starting vertex index,
+// which resolves negative (relative) face indices without a sequential dependency.
+
+namespace {
+
+enum class ObjRec { Other, Vertex, Face };
+
+struct ObjChunk {
+    const char* begin = nullptr;
+    const char* end = nullptr;
+    size_t nv = 0, nf = 0;        // records in this chunk (pass 1)
+    size_t v0 = 0, f0 = 0;        // global index of this chunk's first vertex/face
+    std::string err;              // first error seen in this chunk (pass 2)
+};
+
+inline const char* skip_ws(const char* p, const char* e) { while (p < e && (*p == ' ' || *p == '\t')) ++p; return p; }
+inline const char* skip_token(const char* p, const char* e) { while (p < e && *p != ' ' && *p != '\t' && *p != '\r') ++p; return p; }
+inline const char* line_end(const char* p, const char* e) {
+    const void* q = std::memchr(p, '\n', (size_t)(e - p));
+    return q ? static_cast<const char*>(q) : e;
 }
 
-bool load_obj_tri(const std::string& path, Mesh& mesh, std::string& err) {
-    mesh.clear(); // ensure target is empty before filling
-    std::ifstream ifs(path);
-    if (!ifs) { err = "cannot open: " + path; return false; }
-    std::string line;
-    while (std::getline(ifs, line)) {
-        trim(line);
-        if (line.empty() || line[0]=='#') continue; // ignore comments/blank lines
-        std::istringstream iss(line);
-        std::string tok; iss >> tok; // first token is the record type
-        if (tok == "v") {
-            // Vertex position: v x y z
-            Vec3 v; iss >> v.x >> v.y >> v.z; mesh.verts.push_back(v);
-        } else if (tok == "f") {
-            // Triangle face: f i j k (we ignore vt/vn and only read position indices)
-            std::string s1,s2,s3; iss >> s1 >> s2 >> s3;
-            auto parse_idx = [](const std::string& s)->int{
-                // Accept tokens like "12", "12/34", "12/34/56" and only use the first field.
-                size_t p = s.find('/');
-                std::string a = (p==std::string::npos)? s : s.substr(0,p);
-                int idx = std::stoi(a);
-                return idx; // positive indices assumed (per our own writer)
-            };
-            int i = parse_idx(s1), j = parse_idx(s2), k = parse_idx(s3);
-            // Convert 1-based OBJ indices to 0-based internal indices.
-            mesh.faces.push_back({i-1, j-1, k-1});
+// Record type of the line [p, e): "v" and "f" followed by whitespace; "vt", "vn", comments,
+// blank lines and other directives are Other.
+inline ObjRec classify(const char* p, const char* e) {
+    p = skip_ws(p, e);
+    if (p == e || (*p != 'v' && *p != 'f')) return ObjRec::Other;
+    char t = *p++;
+    if (p != e && *p != ' ' && *p != '\t' && *p != '\r') return ObjRec::Other;
+    return t == 'v' ? ObjRec::Vertex : ObjRec::Face;
+}
+
+inline bool parse_double(const char*& p, const char* e, double& out) {
+    p = skip_ws(p, e);
+    if (p < e && *p == '+') ++p;  // from_chars rejects an explicit plus sign
+    auto r = std::from_chars(p, e, out);
+    if (r.ec != std::errc()) return false;
+    p = r.ptr;
+    return true;
+}
+
+// Parse "i", "i/t", "i//n" or "i/t/n" and return the position index i (first field only).
+inline bool parse_index(const char*& p, const char* e, long long& out) {
+    p = skip_ws(p, e);
+    auto r = std::from_chars(p, e, out);
+    if (r.ec != std::errc()) return false;
+    p = skip_token(r.ptr, e);
+    return true;
+}
+
+void count_chunk(ObjChunk& c) {
+    for (const char* p = c.begin; p < c.end; ) {
+        const char* le = line_end(p, c.end);
+        switch (classify(p, le)) {
+            case ObjRec::Vertex: c.nv++; break;
+            case ObjRec::Face: c.nf++; break;
+            default: break;
+        }
+        p = le + 1;
+    }
+}
+
+// Parse a counted chunk into verts[0, c.nv) and faces[0, c.nf).
+void parse_chunk(ObjChunk& c, const char* file_begin, size_t total_v, Vec3* verts, Tri* faces) {
+    size_t vi = c.v0, fi = 0;
+    for (const char* p = c.begin; p < c.end; ) {
+        const char* le = line_end(p, c.end);
+        ObjRec rec = classify(p, le);
+        const char* q = skip_ws(p, le) + 1;  // past the record letter
+        if (rec == ObjRec::Vertex) {
+            // Vertex position: v x y z (missing or malformed coordinates read as 0, like the
+            // previous stream-based reader).
+            Vec3 v;
+            if (parse_double(q, le, v.x) && parse_double(q, le, v.y)) parse_double(q, le, v.z);
+            verts[vi++ - c.v0] = v;
+        } else if (rec == ObjRec::Face) {
+            // Triangle face: f i j k. Texture/normal indices are ignored and only the first
+            // three corners are used. Negative indices are relative to the vertices read so far.
+            long long idx[3];
+            for (int k = 0; k < 3; ++k) {
+                if (!parse_index(q, le, idx[k]) || idx[k] == 0) {
+                    c.err = "malformed face record at byte " + std::to_string(p - file_begin);
+                    return;
+                }
+                long long z = idx[k] > 0 ? idx[k] - 1 : (long long)vi + idx[k];
+                if (z < 0 || z >= (long long)total_v) {
+                    c.err = "face index out of range at byte " + std::to_string(p - file_begin);
+                    return;
+                }
+                idx[k] = z;
+            }
+            faces[fi++] = {(int)idx[0], (int)idx[1], (int)idx[2]};
         }
-        // Other directives (vt, vn, usemtl, mtllib, o, g, s, etc.) are ignored.
+        p = le + 1;
     }
+}
+
+// Split [begin, end) into k line-aligned chunks and count their records (pass 1); the
+// totals go to nv / nf.
+std::vector<ObjChunk> count_chunks(const char* begin, const char* end, int k, int threads, size_t& nv, size_t& nf) {
+    const size_t size = (size_t)(end - begin);
+    std::vector<ObjChunk> chunks((size_t)k);
+    const char* p = begin;
+    for (int c = 0; c < k; ++c) {
+        const char* e = (c + 1 == k) ? end : begin + size * (size_t)(c + 1) / (size_t)k;
+        if (e < p) e = p;
+        if (e < end) { const char* nl = line_end(e, end); e = (nl == end) ? end : nl + 1; }  // extend to end of line
+        chunks[(size_t)c].begin = p; chunks[(size_t)c].end = e;
+        p = e;
+    }
+    parallel_for(chunks.size(), threads, [&](size_t b, size_t e, int) { for (size_t c = b; c < e; ++c) count_chunk(chunks[c]); }, 1);
+    nv = 0; nf = 0;
+    for (auto& c : chunks) { c.v0 = nv; c.f0 = nf; nv += c.nv; nf += c.nf; }
+    return chunks;
+}
+
+} // namespace
+
+bool load_obj_tri(const std::string& path, Mesh& mesh, std::string& err, int threads) {
+    mesh.clear(); // ensure target is empty before filling
+    MappedFile file;
+    if (!file.open(path, err)) return false;
+    const char* begin = file.data();
+
+    // Line-aligned chunks (>= 1 MiB each so small files stay single-threaded).
+    // Pass 1: count records per chunk, then size the arrays once.
+    const int k = parallel_chunks(file.size(), resolve_threads(threads), (size_t)1 << 20);
+    size_t nv = 0, nf = 0;
+    std::vector<ObjChunk> chunks = count_chunks(begin, begin + file.size(), k, k, nv, nf);
     // Basic sanity: require at least one vertex and one face.
-    if (mesh.verts.empty() || mesh.faces.empty()) { err = "empty mesh from: " + path; return false; }
+    if (nv == 0 || nf == 0) { err = "empty mesh from: " + path; return false; }
+    mesh.verts.resize(nv);
+    mesh.faces.resize(nf);
+
+    // Pass 2: parse every chunk into its own slice of the arrays.
+    parallel_for(chunks.size(), k, [&](size_t b, size_t e, int) {
+        for (size_t c = b; c < e; ++c) parse_chunk(chunks[c], begin, nv, mesh.verts.data() + chunks[c].v0, mesh.faces.data() + chunks[c].f0);
+    }, 1);
+    for (auto& c : chunks) {
+        if (!c.err.empty()) { err = c.err + " in: " + path; mesh.clear(); return false; }
+    }
     return true;
 }
 
-bool save_obj_tri(const std::string& path, const Mesh& mesh, std::string& err) {
-    std::ofstream ofs(path);
-    if (!ofs) { err = "cannot write: " + path; return false; }
-    ofs << "# meshqem output\n"; // simple banner for debugging
-    // Emit vertex positions.
-    for (auto& v : mesh.verts) {
-        ofs << "v " << v.x << ' ' << v.y << ' ' << v.z << '\n';
+// Same two passes with fixed-size chunks: pass 2 parses one wave of chunks (one per thread)
+// into private buffers and appends them to the MQB file in order, so memory stays bounded by
+// the wave whatever the file size.
+bool convert_obj_to_bin(const std::string& obj_path, const std::string& bin_path, std::string& err, int threads) {
+    MappedFile file;
+    if (!file.open(obj_path, err)) return false;
+    const char* begin = file.data();
+    const int t = resolve_threads(threads);
+    const size_t kSlab = (size_t)32 << 20;
+    const int k = (int)std::max<size_t>(1, (file.size() + kSlab - 1) / kSlab);
+    size_t nv = 0, nf = 0;
+    std::vector<ObjChunk> chunks = count_chunks(begin, begin + file.size(), k, t, nv, nf);
+    if (nv == 0 || nf == 0) { err = "empty mesh from: " + obj_path; return false; }
+
+    MeshBinWriter out;
+    if (!out.open(bin_path, nv, nf, err)) return false;
+    auto fail = [&](const std::string& msg) { std::string ignored; out.close(ignored); std::remove(bin_path.c_str()); err = msg; return false; };
+    std::vector<Mesh> buf((size_t)std::min(k, t));
+    for (size_t c0 = 0; c0 < chunks.size(); c0 += buf.size()) {
+        const size_t n = std::min(buf.size(), chunks.size() - c0);
+        parallel_for(n, t, [&](size_t b, size_t e, int) {
+            for (size_t i = b; i < e; ++i) {
+                ObjChunk& c = chunks[c0 + i];
+                buf[i].verts.resize(c.nv); buf[i].faces.resize(c.nf);
+                parse_chunk(c, begin, nv, buf[i].verts.data(), buf[i].faces.data());
+            }
+        }, 1);
+        for (size_t i = 0; i < n; ++i) {
+            const ObjChunk& c = chunks[c0 + i];
+            if (!c.err.empty()) return fail(c.err + " in: " + obj_path);
+            if (!out.append_verts(buf[i].verts.data(), c.nv) || !out.append_faces(buf[i].faces.data(), c.nf)) return fail("write failed: " + bin_path);
+        }
     }
-    // Emit triangle faces. OBJ is 1-based, so we add 1 to each index.
-    for (auto& f : mesh.faces) {
-        ofs << "f " << (f.a+1) << ' ' << (f.b+1) << ' ' << (f.c+1) << '\n';
+    if (!out.close(err)) { std::remove(bin_path.c_str()); return false; }
+    return true;
+}
+
+// ---- writer --------------------------------------------------------------------------
+// Records are formatted with std::to_chars: shortest round-trip representation for
+// coordinates (a save/load cycle restores every double bit-for-bit) and no locale work.
+// Vertices and faces are cut into fixed-size blocks; one wave of blocks is formatted (in
+// parallel when threads > 1) into private buffers, then the buffers are written in order
+// with large fwrite calls. Memory stays bounded by one wave regardless of mesh size.
+
+namespace {
+
+constexpr size_t kBlockItems = (size_t)1 << 16;  // records per formatted block
+constexpr size_t kMaxVertexLine = 2 + 3 * 25 + 1; // "v " + 3 x (shortest double + sep) + '\n'
+constexpr size_t kMaxFaceLine = 2 + 3 * 12 + 1;   // "f " + 3 x (int + sep) + '\n'
+
+inline char* put_vertex(char* p, const Vec3& v) {
+    *p++ = 'v';
+    for (double x : {v.x, v.y, v.z}) { *p++ = ' '; p = std::to_chars(p, p + 25, x).ptr; }
+    *p++ = '\n';
+    return p;
+}
+
+inline char* put_face(char* p, const Tri& f) {
+    *p++ = 'f';
+    for (int i : {f.a, f.b, f.c}) { *p++ = ' '; p = std::to_chars(p, p + 12, i + 1).ptr; } // OBJ is 1-based
+    *p++ = '\n';
+    return p;
+}
+
+// Format `n` records in blocks of kBlockItems and append them to `out` in order.
+template <class Put>
+bool write_blocks(std::FILE* out, size_t n, size_t max_line, int threads, Put put) {
+    const size_t blocks = (n + kBlockItems - 1) / kBlockItems;
+    const size_t wave = (size_t)std::max(1, threads) * 2;
+    std::vector<std::vector<char>> buf(std::min(blocks, wave));
+    for (size_t b0 = 0; b0 < blocks; b0 += wave) {
+        const size_t nb = std::min(wave, blocks - b0);
+        parallel_for(nb, threads, [&](size_t lo, size_t hi, int) {
+            for (size_t k = lo; k < hi; ++k) {
+                const size_t i0 = (b0 + k) * kBlockItems, i1 = std::min(n, i0 + kBlockItems);
+                auto& bk = buf[k];
+                bk.resize((i1 - i0) * max_line);
+                char* p = bk.data();
+                for (size_t i = i0; i < i1; ++i) p = put(p, i);
+                bk.resize((size_t)(p - bk.data()));
+            }
+        }, 1);
+        for (size_t k = 0; k < nb; ++k) {
+            if (std::fwrite(buf[k].data(), 1, buf[k].size(), out) != buf[k].size()) return false;
+        }
     }
     return true;
 }
+
+} // namespace
+
+bool save_obj_tri(const std::string& path, const Mesh& mesh, std::string& err, int threads) {
+    std::FILE* out = std::fopen(path.c_str(), "wb");
+    if (!out) { err = "cannot write: " + path; return false; }
+    const int t = resolve_threads(threads);
+    bool ok = std::fputs("# meshqem output\n", out) >= 0; // simple banner for debugging
+    // Emit vertex positions, then triangle faces.
+    ok = ok && write_blocks(out, mesh.verts.size(), kMaxVertexLine, t,
+                            [&](char* p, size_t i) { return put_vertex(p, mesh.verts[i]); });
+    ok = ok && write_blocks(out, mesh.faces.size(), kMaxFaceLine, t,
+                            [&](char* p, size_t i) { return put_face(p, mesh.faces[i]); });
+    ok = (std::fclose(out) == 0) && ok;
+    if (!ok) { err = "write failed: " + path; return false; }
+    return true;
+}
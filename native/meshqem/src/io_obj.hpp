@@ -3,7 +3,8 @@
 // Scope and limitations:
 // - Supports only vertex positions (v) and triangle faces (f i j k).
 // - Ignores texture/normal indices (vt/vn) and materials; ideal for algorithm I/O.
-// - Parses positive indices only (1-based per OBJ spec), converts to 0-based.
+// - Parses positive (1-based per OBJ spec) and negative (relative) indices, converts to 0-based.
+// - Faces with more than three corners contribute their first three only.
 // - Lines starting with '#' are treated as comments and skipped.
 //
 #pragma once
@@ -12,8 +13,17 @@
 
 // Load triangles from an OBJ file located at `path` into `mesh`.
 // On failure, returns false and writes a human-readable message to `err`.
-bool load_obj_tri(const std::string& path, Mesh& mesh, std::string& err);
+// `threads` > 1 (or <= 0 for all cores) parses large files in parallel line-aligned chunks;
+// the result is identical for any thread count.
+bool load_obj_tri(const std::string& path, Mesh& mesh, std::string& err, int threads = 1);
+
+// Convert an OBJ file to MQB (io_bin.hpp) without loading the mesh: the file is parsed in
+// 32 MiB chunks, one per thread at a time, and written out as it goes, so memory does not
+// grow with the file. Same parsing rules and result as load_obj_tri + save_mesh_bin.
+bool convert_obj_to_bin(const std::string& obj_path, const std::string& bin_path, std::string& err, int threads = 1);
 
 // Save the triangle mesh to an OBJ file located at `path`.
 // On failure, returns false and writes a human-readable message to `err`.
-bool save_obj_tri(const std::string& path, const Mesh& mesh, std::string& err);
+// Coordinates use the shortest representation that round-trips exactly; `threads` > 1
+// formats blocks in parallel (output bytes do not depend on the thread count).
+bool save_obj_tri(const std::string& path, const Mesh& mesh, std::string& err, int threads = 1);
@@ -0,0 +1,49 @@
+// mapped_file.cpp — mmap on POSIX, whole-file read as the portable fallback.
+
+#include "mapped_file.hpp"
+#include <fstream>
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+bool MappedFile::open(const std::string& path, std::string& err) {
+    close();
+#if !defined(_WIN32)
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) { err = "cannot open: " + path; return false; }
+    struct stat st{};
+    const bool have_stat = ::fstat(fd, &st) == 0;
+    if (have_stat && st.st_size > 0) {
+        void* p = ::mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p != MAP_FAILED) {
+            ::madvise(p, (size_t)st.st_size, MADV_SEQUENTIAL);  // hint: front-to-back scan
+            data_ = static_cast<const char*>(p); size_ = (size_t)st.st_size; mapped_ = true;
+            ::close(fd);
+            return true;
+        }
+    }
+    ::close(fd);
+    if (have_stat && st.st_size == 0) { data_ = nullptr; size_ = 0; return true; }  // empty file: nothing to map
+#endif
+    // Fallback: read the whole file into memory.
+    std::ifstream ifs(path, std::ios::binary);
+    if (!ifs) { err = "cannot open: " + path; return false; }
+    ifs.seekg(0, std::ios::end);
+    std::streamoff n = ifs.tellg();
+    ifs.seekg(0, std::ios::beg);
+    buffer_.resize(n > 0 ? (size_t)n : 0);
+    if (n > 0 && !ifs.read(buffer_.data(), n)) { err = "cannot read: " + path; buffer_.clear(); return false; }
+    data_ = buffer_.data(); size_ = buffer_.size();
+    return true;
+}
+
+void MappedFile::close() {
+#if !defined(_WIN32)
+    if (mapped_) ::munmap(const_cast<char*>(data_), size_);
+#endif
+    data_ = nullptr; size_ = 0; mapped_ = false;
+    buffer_.clear(); buffer_.shrink_to_fit();
+}
@@ -0,0 +1,31 @@
+// mapped_file.hpp — Read-only view of a whole file, memory-mapped where the OS allows it.
+//
+// On POSIX the file is mmap'ed (pages are faulted in lazily and shared with the page
+// cache); elsewhere, or if mapping fails, the file is read into an owned buffer. Either
+// way callers see one contiguous [data(), data()+size()) range valid until close().
+//
+#pragma once
+#include <cstddef>
+#include <string>
+#include <vector>
+
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile() { close(); }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Map `path`; on failure returns false and writes a message to `err`.
+    bool open(const std::string& path, std::string& err);
+    void close();
+
+    const char* data() const { return data_; }
+    size_t size() const { return size_; }
+
+private:
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+    bool mapped_ = false;       // true: data_ came from mmap and must be unmapped
+    std::vector<char> buffer_;  // fallback storage when mapping is unavailable
+};
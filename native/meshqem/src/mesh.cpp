@@ -4,8 +4,13 @@
 #include "mesh.hpp"
 
 // Clear geometry buffers; this is used by I/O to reset target before loading.
-void Mesh::clear() {
+template <class T>
+void MeshT<T>::clear() {
     verts.clear();   // drop all vertex positions
     faces.clear();   // drop all triangle indices
     face_uvs.clear(); // drop any per-face UV triplets (if present)
+    face_ids.clear(); // and any per-face source ids
 }
+
+template struct MeshT<double>;
+template struct MeshT<float>;
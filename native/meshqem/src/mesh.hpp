@@ -3,10 +3,13 @@
 // Design goals:
 // - Keep data structures tiny and explicit so the algorithm's intent is clear.
 // - Avoid coupling to external libraries (Eigen, glm, etc.) for easy embedding.
-// - Use double for positions to reduce accumulated numerical error in QEM.
+// - Use double for positions to reduce accumulated numerical error in QEM. MeshF stores
+//   positions and UVs as float (half the memory, e.g. for float32 USD points); the
+//   simplifier still does all quadric math in double (see qem.hpp).
 //
 // Conventions used across meshqem:
-// - Triangle-only: all faces are 3 indices (Tri). Non-tri meshes must be pre-triangulated.
+// - Triangle-only: all faces are 3 indices (Tri). Non-tri meshes must be pre-triangulated
+//   (triangulate_polygons in polygon.hpp does this for USD-style polygon input).
 // - Indices are 0-based in memory (OBJ uses 1-based; we convert in I/O layer).
 // - No attributes (normals/UVs) are tracked in v1; topology-only simplification.
 //
@@ -17,7 +20,9 @@
 #include <unordered_set>
 
 // 3D point/vector. We use a plain struct for cache-friendly access.
-struct Vec3 { double x{}, y{}, z{}; };
+template <class T> struct Vec3T { T x{}, y{}, z{}; };
+using Vec3  = Vec3T<double>;
+using Vec3f = Vec3T<float>;
 
 // Triangle face made of 3 vertex indices (0-based).
 // The algorithm assumes indices are valid and form a manifold-ish mesh, but we keep
@@ -31,15 +36,24 @@ struct Tri { int a{}, b{}, c{}; };
 //   用于在简化时“跟着面一起删/压缩”，不在 C++ 端修改具体值；
 // - 为空时，表示当前运行不关心 UV 属性，qem_simplify 将忽略它。
 // 该字段只在嵌入式调用（例如 Python 绑定）中使用，命令行 OBJ I/O 仍然保持 v1 的几何-only 语义。
-struct Mesh {
+// T is the storage type of positions and UVs: Mesh (double) everywhere, MeshF (float) for
+// the float-storage entry points of qem.hpp, weld.hpp, cluster.hpp and polygon.hpp.
+template <class T>
+struct MeshT {
+    using Real = T;
+
     // Vertex positions (units agnostic; typically scene units in USD/OBJ).
-    std::vector<Vec3> verts;
+    std::vector<Vec3T<T>> verts;
     // Triangle faces. Each entry is a 3-tuple of indices into verts.
     std::vector<Tri>  faces; // triangles only
 
     // Optional per-face UV triplets: (u0,v0,u1,v1,u2,v2) for each triangle.
     // 保持与 faces 同长度/顺序，用于“删面时同步删对应的 UV triplet；压缩时同步压缩”。
-    std::vector<std::array<double, 6>> face_uvs;
+    std::vector<std::array<T, 6>> face_uvs;
+
+    // Optional per-face source id, e.g. the USD polygon a triangle was cut from (polygon.hpp).
+    // Same contract as face_uvs: carried along only when face_ids.size() == faces.size().
+    std::vector<int> face_ids;
 
     // Clear all geometry. Does not shrink capacity (standard vector behavior).
     void clear();
@@ -48,3 +62,6 @@ struct Mesh {
     size_t num_faces() const { return faces.size(); }
     size_t num_verts() const { return verts.size(); }
 };
+
+using Mesh  = MeshT<double>;
+using MeshF = MeshT<float>;
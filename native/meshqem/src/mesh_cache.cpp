@@ -0,0 +1,138 @@
+// mesh_cache.cpp — XXH64 keys, the in-memory LRU cache and the on-disk MQB cache.
+
+#include "mesh_cache.hpp"
+#include "io_bin.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <thread>
+
+// ---- XXH64 (reference algorithm, little-endian reads) ----
+static const uint64_t P1 = 11400714785074694791ULL, P2 = 14029467366897019727ULL, P3 = 1609587929392839161ULL,
+                      P4 = 9650029242287828579ULL,  P5 = 2870177450012600261ULL;
+static inline uint64_t rotl(uint64_t x, int r) { return (x << r) | (x >> (64 - r)); }
+static inline uint64_t rd64(const unsigned char* p) { uint64_t v; std::memcpy(&v, p, 8); return v; }
+static inline uint32_t rd32(const unsigned char* p) { uint32_t v; std::memcpy(&v, p, 4); return v; }
+static inline uint64_t round64(uint64_t acc, uint64_t in) { acc += in * P2; return rotl(acc, 31) * P1; }
+static inline uint64_t merge64(uint64_t h, uint64_t v) { h ^= round64(0, v); return h * P1 + P4; }
+
+uint64_t xxh64(const void* data, size_t len, uint64_t seed) {
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    const unsigned char* const end = p + len;
+    uint64_t h;
+    if (len >= 32) {
+        uint64_t v1 = seed + P1 + P2, v2 = seed + P2, v3 = seed, v4 = seed - P1;
+        for (const unsigned char* lim = end - 32; p <= lim; p += 32) {
+            v1 = round64(v1, rd64(p)); v2 = round64(v2, rd64(p + 8)); v3 = round64(v3, rd64(p + 16)); v4 = round64(v4, rd64(p + 24));
+        }
+        h = rotl(v1, 1) + rotl(v2, 7) + rotl(v3, 12) + rotl(v4, 18);
+        h = merge64(h, v1); h = merge64(h, v2); h = merge64(h, v3); h = merge64(h, v4);
+    } else {
+        h = seed + P5;
+    }
+    h += (uint64_t)len;
+    for (; p + 8 <= end; p += 8) h = rotl(h ^ round64(0, rd64(p)), 27) * P1 + P4;
+    if (p + 4 <= end) { h = rotl(h ^ ((uint64_t)rd32(p) * P1), 23) * P2 + P3; p += 4; }
+    for (; p < end; ++p) h = rotl(h ^ ((uint64_t)*p * P5), 11) * P1;
+    h ^= h >> 33; h *= P2; h ^= h >> 29; h *= P3; h ^= h >> 32;
+    return h;
+}
+
+uint64_t mesh_cache_key(const Mesh& mesh, const SimplifyOptions& opt) {
+    // Buffers are chained through the seed; the header pins the sizes so that moving bytes
+    // between buffers cannot produce the same stream.
+    // partitions < 0 means "one per thread" (or, deterministic, a count from the face count),
+    // so the resolved count is what changes the output.
+    int64_t parts = resolve_partitions(opt, mesh.faces.size());
+    if (parts <= 1) parts = 0;
+    struct { uint64_t nv, nf, nuv, nid; double ratio; int64_t target_faces, max_collapses; double weld_eps; int64_t partitions, method; double max_error; int64_t relative, placement, reorder; double boundary_weight, seam_weight; int64_t guard; } head{
+        mesh.verts.size(), mesh.faces.size(), mesh.face_uvs.size(), mesh.face_ids.size(), opt.ratio, opt.target_faces, opt.max_collapses, opt.weld_eps, parts, (int64_t)opt.method,
+        opt.max_error < 0 ? -1.0 : opt.max_error, (int64_t)(opt.max_error >= 0 && opt.max_error_relative), (int64_t)opt.placement, (int64_t)opt.reorder,
+        std::max(0.0, opt.boundary_weight), std::max(0.0, opt.seam_weight), (int64_t)opt.guard };
+    uint64_t h = xxh64(&head, sizeof(head), 0x4d51454dULL);
+    h = xxh64(mesh.verts.data(), mesh.verts.size() * sizeof(Vec3), h);
+    h = xxh64(mesh.faces.data(), mesh.faces.size() * sizeof(Tri), h);
+    h = xxh64(mesh.face_uvs.data(), mesh.face_uvs.size() * sizeof(mesh.face_uvs[0]), h);
+    h = xxh64(mesh.face_ids.data(), mesh.face_ids.size() * sizeof(int), h);
+    return h;
+}
+
+void fill_cached_report(const Mesh& input, const Mesh& result, SimplifyReport& rep) {
+    rep = SimplifyReport{};
+    rep.faces_before = input.faces.size(); rep.verts_before = input.verts.size();
+    rep.faces_after = result.faces.size(); rep.verts_after = result.verts.size();
+    rep.from_cache = true;
+}
+
+// ---- MeshCache ----
+static size_t mesh_bytes(const Mesh& m) {
+    return m.verts.size() * sizeof(Vec3) + m.faces.size() * sizeof(Tri) + m.face_uvs.size() * sizeof(m.face_uvs[0])
+         + m.face_ids.size() * sizeof(int);
+}
+
+bool MeshCache::get(uint64_t key, Mesh& out) {
+    std::shared_ptr<const Mesh> hit;
+    {
+        std::lock_guard<std::mutex> lk(m_);
+        auto it = index_.find(key);
+        if (it == index_.end()) { misses_++; return false; }
+        lru_.splice(lru_.begin(), lru_, it->second);
+        hit = it->second->mesh; hits_++;
+    }
+    out = *hit;  // copied outside the lock; eviction cannot free it while we hold the pointer
+    return true;
+}
+
+void MeshCache::put(uint64_t key, const Mesh& result) {
+    const size_t b = mesh_bytes(result);
+    std::lock_guard<std::mutex> lk(m_);
+    if (b > limit_) return;  // would evict everything (also covers a disabled cache)
+    auto it = index_.find(key);
+    if (it != index_.end()) { bytes_ -= it->second->bytes; lru_.erase(it->second); index_.erase(it); }
+    lru_.push_front(Entry{key, std::make_shared<const Mesh>(result), b});
+    index_[key] = lru_.begin();
+    bytes_ += b;
+    evict_locked();
+}
+
+void MeshCache::evict_locked() {
+    while (bytes_ > limit_ && !lru_.empty()) {
+        bytes_ -= lru_.back().bytes;
+        index_.erase(lru_.back().key);
+        lru_.pop_back();
+    }
+}
+
+void MeshCache::set_limit(size_t max_bytes) { std::lock_guard<std::mutex> lk(m_); limit_ = max_bytes; evict_locked(); }
+void MeshCache::clear() { std::lock_guard<std::mutex> lk(m_); lru_.clear(); index_.clear(); bytes_ = 0; }
+size_t MeshCache::bytes() const { std::lock_guard<std::mutex> lk(m_); return bytes_; }
+size_t MeshCache::size() const { std::lock_guard<std::mutex> lk(m_); return lru_.size(); }
+size_t MeshCache::hits() const { std::lock_guard<std::mutex> lk(m_); return hits_; }
+size_t MeshCache::misses() const { std::lock_guard<std::mutex> lk(m_); return misses_; }
+
+// ---- on-disk cache ----
+static std::string cache_path(const std::string& dir, uint64_t key) {
+    char name[24];
+    std::snprintf(name, sizeof(name), "%016llx.mqb", (unsigned long long)key);
+    return dir.empty() || dir.back() == '/' ? dir + name : dir + "/" + name;
+}
+
+bool disk_cache_load(const std::string& dir, uint64_t key, Mesh& out) {
+    std::string err;
+    return load_mesh_bin(cache_path(dir, key), out, err);  // missing or unreadable = miss
+}
+
+bool disk_cache_store(const std::string& dir, uint64_t key, const Mesh& result, std::string& err) {
+    static std::atomic<unsigned> seq{0};
+    const std::string path = cache_path(dir, key);
+    char suffix[48];
+    const size_t salt = std::hash<std::thread::id>()(std::this_thread::get_id()) ^ (size_t)std::chrono::steady_clock::now().time_since_epoch().count();
+    std::snprintf(suffix, sizeof(suffix), ".tmp%zx.%u", salt, seq.fetch_add(1));
+    const std::string tmp = path + suffix;
+    if (!save_mesh_bin(tmp, result, err)) { std::remove(tmp.c_str()); return false; }
+    if (std::rename(tmp.c_str(), path.c_str()) != 0) { std::remove(tmp.c_str()); err = "cannot rename into: " + path; return false; }
+    return true;
+}
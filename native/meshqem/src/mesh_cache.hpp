@@ -0,0 +1,71 @@
+// mesh_cache.hpp — Content-hash result cache for repeated and instanced meshes.
+//
+// A key is an XXH64 hash of the vertex, face, face-UV and face-id buffers plus the
+// SimplifyOptions that influence the result (ratio, target_faces, max_collapses, weld_eps,
+// partitions, method). threads, progress_interval and collect_stats do not change the
+// output, so they are left out, and so are time_limit and the progress / cancel hooks:
+// time-limited and cancelled results are never stored, and a run that finished is the
+// same whatever the limit was. Keys are 64-bit and are trusted without comparing the
+// input again; with the cache sizes used here a false hit is vanishingly unlikely.
+//
+// - MeshCache: in-memory, thread-safe, bounded by the bytes of the stored meshes, LRU eviction.
+//   qem_simplify_batch() takes one and also shares one result between identical items.
+// - disk_cache_*: one MQB file per key in a directory, used by the CLI's --cache-dir. Files are
+//   written to a temporary name and renamed, so concurrent writers never expose partial files.
+//   The directory is not size-bounded; delete it to reclaim space.
+//
+#pragma once
+#include "mesh.hpp"
+#include "qem.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+// XXH64 of a byte buffer.
+uint64_t xxh64(const void* data, size_t len, uint64_t seed);
+
+// Cache key of simplifying `mesh` with `opt`.
+uint64_t mesh_cache_key(const Mesh& mesh, const SimplifyOptions& opt);
+
+// Whether a finished run may be stored under its key.
+inline bool cacheable(const SimplifyReport& rep) { return !rep.stats.time_limited && !rep.stats.cancelled; }
+
+// Report of a result served from a cache: counts only, stats left zero.
+void fill_cached_report(const Mesh& input, const Mesh& result, SimplifyReport& rep);
+
+class MeshCache {
+public:
+    // max_bytes bounds the sum of the stored meshes' buffer sizes; 0 disables the cache.
+    explicit MeshCache(size_t max_bytes = 0) : limit_(max_bytes) {}
+    MeshCache(const MeshCache&) = delete;
+    MeshCache& operator=(const MeshCache&) = delete;
+
+    // Copy the result stored under `key` into `out`; marks it most recently used.
+    bool get(uint64_t key, Mesh& out);
+    // Store a result (replacing any entry with the same key) and evict down to the limit.
+    void put(uint64_t key, const Mesh& result);
+
+    void set_limit(size_t max_bytes);
+    void clear();
+    size_t bytes() const;
+    size_t size() const;
+    size_t hits() const;
+    size_t misses() const;
+
+private:
+    struct Entry { uint64_t key; std::shared_ptr<const Mesh> mesh; size_t bytes; };
+    void evict_locked();
+
+    mutable std::mutex m_;
+    std::list<Entry> lru_;            // front = most recently used
+    std::unordered_map<uint64_t, std::list<Entry>::iterator> index_;
+    size_t limit_ = 0, bytes_ = 0, hits_ = 0, misses_ = 0;
+};
+
+// On-disk cache: <dir>/<key as 16 hex digits>.mqb
+bool disk_cache_load(const std::string& dir, uint64_t key, Mesh& out);
+bool disk_cache_store(const std::string& dir, uint64_t key, const Mesh& result, std::string& err);
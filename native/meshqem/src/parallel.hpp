@@ -0,0 +1,78 @@
+// parallel.hpp — Tiny fork/join helpers for the data-parallel setup phases of meshqem.
+//
+// Design goals:
+// - Header-only, std::thread based; no thread pool state to manage for one-shot loops.
+// - Static contiguous chunking: chunk k always covers the same index range for a given
+//   (n, threads), and callers write per-chunk results that are concatenated in chunk
+//   order, so results do not depend on scheduling.
+// - Small inputs run inline on the calling thread (spawning is not free).
+//
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Map the user-facing thread option to a worker count: <=0 means "all hardware threads".
+inline int resolve_threads(int threads) {
+    if (threads > 0) return threads;
+    unsigned hw = std::thread::hardware_concurrency();
+    return hw ? (int)hw : 1;
+}
+
+// Number of chunks parallel_for will use for n items (at least `grain` items per chunk).
+inline int parallel_chunks(size_t n, int threads, size_t grain = 4096) {
+    if (threads <= 1 || n <= grain) return 1;
+    return (int)std::min<size_t>((size_t)threads, (n + grain - 1) / grain);
+}
+
+// Run fn(begin, end, chunk) over [0, n) split into parallel_chunks(n, threads, grain)
+// contiguous ranges. Chunk 0 runs on the calling thread.
+template <class F>
+void parallel_for(size_t n, int threads, F&& fn, size_t grain = 4096) {
+    int k = parallel_chunks(n, threads, grain);
+    if (k <= 1) { if (n) fn((size_t)0, n, 0); return; }
+    std::vector<std::thread> pool;
+    pool.reserve((size_t)k - 1);
+    auto range = [&](int c) { return std::make_pair(n * (size_t)c / (size_t)k, n * (size_t)(c + 1) / (size_t)k); };
+    for (int c = 1; c < k; ++c) {
+        auto r = range(c);
+        pool.emplace_back([&fn, r, c] { fn(r.first, r.second, c); });
+    }
+    auto r0 = range(0);
+    fn(r0.first, r0.second, 0);
+    for (auto& t : pool) t.join();
+}
+
+// Bottom-up (Floyd) heap construction producing a valid heap for the std heap
+// algorithms: a max-heap under operator<, children of i at 2i+1 and 2i+2.
+// Nodes on one tree level root disjoint subtrees, so each level is sifted in parallel,
+// deepest level first; the resulting layout does not depend on the thread count.
+template <class T>
+void parallel_make_heap(std::vector<T>& h, int threads) {
+    const size_t n = h.size();
+    if (n < 2) return;
+    auto sift_down = [&h, n](size_t i) {
+        T x = h[i];
+        for (;;) {
+            size_t c = 2 * i + 1;
+            if (c >= n) break;
+            if (c + 1 < n && h[c] < h[c + 1]) ++c;
+            if (!(x < h[c])) break;
+            h[i] = h[c]; i = c;
+        }
+        h[i] = x;
+    };
+    const size_t last_parent = n / 2 - 1;
+    size_t first = 0;                            // level k covers [2^k - 1, 2^(k+1) - 2]
+    while (first * 2 + 1 <= last_parent) first = first * 2 + 1;
+    for (;;) {
+        const size_t lo = first, hi = std::min(last_parent, first * 2);
+        parallel_for(hi - lo + 1, threads, [&](size_t b, size_t e, int) {
+            for (size_t i = lo + e; i-- > lo + b; ) sift_down(i);
+        }, 1024);
+        if (first == 0) break;
+        first = (first - 1) / 2;
+    }
+}
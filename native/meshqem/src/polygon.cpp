@@ -0,0 +1,167 @@
+// polygon.cpp — Fan and ear-clipping triangulation of USD-style polygon meshes.
+
+#include "polygon.hpp"
+#include "parallel.hpp"
+#include <climits>
+#include <cmath>
+#include <vector>
+
+namespace {
+
+// Per-thread buffers for ear clipping.
+struct ClipScratch { std::vector<double> xy; std::vector<int> prv, nxt; };
+
+inline double cross2(const double* o, const double* a, const double* b) {
+    return (a[0] - o[0]) * (b[1] - o[1]) - (a[1] - o[1]) * (b[0] - o[0]);
+}
+
+// Project the polygon's corners onto the plane of its Newell normal, dropping the dominant
+// axis and flipping as needed so the polygon runs counter-clockwise. False if degenerate.
+template <class V>
+bool project(const V* P, const int* idx, int n, std::vector<double>& xy) {
+    double nrm[3] = {0, 0, 0};
+    for (int i = 0; i < n; ++i) {
+        const V &a = P[idx[i]], &b = P[idx[i + 1 == n ? 0 : i + 1]];
+        nrm[0] += (a.y - b.y) * (a.z + b.z);
+        nrm[1] += (a.z - b.z) * (a.x + b.x);
+        nrm[2] += (a.x - b.x) * (a.y + b.y);
+    }
+    int k = 0;
+    for (int d = 1; d < 3; ++d) if (std::fabs(nrm[d]) > std::fabs(nrm[k])) k = d;
+    if (!(std::fabs(nrm[k]) > 0)) return false;
+    const int ax = (k + 1) % 3, ay = (k + 2) % 3;  // (y,z), (z,x), (x,y): CCW seen from +axis k
+    const double s = nrm[k] > 0 ? 1.0 : -1.0;
+    xy.resize(2 * (size_t)n);
+    for (int i = 0; i < n; ++i) {
+        const V& p = P[idx[i]];
+        const double c[3] = {p.x, p.y, p.z};
+        xy[2 * i] = c[ax]; xy[2 * i + 1] = s * c[ay];
+    }
+    return true;
+}
+
+// Corner triples (local 0..n-1) of an n-gon's n-2 triangles, written to `out`.
+template <class V>
+void triangulate_one(const V* P, const int* idx, int n, Triangulation mode, ClipScratch& sc, int* out) {
+    if (mode == Triangulation::Fan || n == 3 || !project(P, idx, n, sc.xy)) {
+        for (int i = 1; i + 1 < n; ++i) { *out++ = 0; *out++ = i; *out++ = i + 1; }
+        return;
+    }
+    const double* p = sc.xy.data();
+    if (n == 4) {
+        // A simple quad has at most one reflex corner, and only the diagonal through it is inside.
+        const bool use13 = cross2(p + 0, p + 2, p + 4) < 0 || cross2(p + 4, p + 6, p + 0) < 0;
+        const int t[6] = {0, 1, 2, 0, 2, 3}, u[6] = {1, 2, 3, 1, 3, 0};
+        for (int i = 0; i < 6; ++i) out[i] = use13 ? u[i] : t[i];
+        return;
+    }
+    sc.prv.resize((size_t)n); sc.nxt.resize((size_t)n);
+    for (int i = 0; i < n; ++i) { sc.prv[i] = i ? i - 1 : n - 1; sc.nxt[i] = i + 1 < n ? i + 1 : 0; }
+    int* prv = sc.prv.data(); int* nxt = sc.nxt.data();
+    auto same = [p](int a, int b) { return p[2 * a] == p[2 * b] && p[2 * a + 1] == p[2 * b + 1]; };
+    // Convex corner whose triangle holds no other remaining corner (duplicates of its own
+    // corners, e.g. along a bridge cut, do not count).
+    auto is_ear = [&](int a, int b, int c) {
+        if (cross2(p + 2 * a, p + 2 * b, p + 2 * c) <= 0) return false;
+        for (int r = nxt[c]; r != a; r = nxt[r]) {
+            if (same(r, a) || same(r, b) || same(r, c)) continue;
+            const double* q = p + 2 * r;
+            if (cross2(p + 2 * a, p + 2 * b, q) >= 0 && cross2(p + 2 * b, p + 2 * c, q) >= 0 && cross2(p + 2 * c, p + 2 * a, q) >= 0) return false;
+        }
+        return true;
+    };
+    int left = n, i = 0, miss = 0;
+    while (left > 3) {
+        const int a = prv[i], c = nxt[i];
+        // After a full lap without an ear (self-intersecting or degenerate input), clip anyway.
+        if (is_ear(a, i, c) || ++miss >= left) {
+            *out++ = a; *out++ = i; *out++ = c;
+            nxt[a] = c; prv[c] = a; --left; miss = 0;
+        }
+        i = c;
+    }
+    *out++ = prv[i]; *out++ = i; *out++ = nxt[i];
+}
+
+} // namespace
+
+template <class T>
+bool triangulate_polygons(MeshT<T>& mesh, const PolygonInput& in, Triangulation mode, bool keep_face_ids,
+                          std::string& err, int threads) {
+    mesh.faces.clear(); mesh.face_uvs.clear(); mesh.face_ids.clear();
+    const size_t np = in.num_polys, ni = in.num_indices, nv = mesh.verts.size();
+    if ((np && !in.counts) || (ni && !in.indices)) { err = "polygons: missing counts or indices"; return false; }
+    if (np > (size_t)INT_MAX) { err = "polygons: too many polygons"; return false; }
+    const int nt = resolve_threads(threads);
+
+    // Pass 1: corners and triangles per chunk; pass 2 uses the same chunks, so the prefix
+    // sums give every chunk its output range.
+    const int k = parallel_chunks(np, nt);
+    std::vector<size_t> c_off((size_t)k + 1, 0), t_off((size_t)k + 1, 0);
+    std::vector<char> bad((size_t)k, 0);
+    parallel_for(np, nt, [&](size_t b, size_t e, int c) {
+        size_t sc = 0, st = 0;
+        for (size_t i = b; i < e; ++i) {
+            const int n = in.counts[i];
+            if (n < 0) { bad[(size_t)c] = 1; return; }
+            sc += (size_t)n;
+            if (n >= 3) st += (size_t)n - 2;
+        }
+        c_off[(size_t)c + 1] = sc; t_off[(size_t)c + 1] = st;
+    });
+    for (char x : bad) if (x) { err = "polygons: negative face vertex count"; return false; }
+    for (int c = 0; c < k; ++c) { c_off[c + 1] += c_off[c]; t_off[c + 1] += t_off[c]; }
+    if (c_off[(size_t)k] != ni) {
+        err = "polygons: faceVertexCounts sum to " + std::to_string(c_off[(size_t)k]) + " but faceVertexIndices has " + std::to_string(ni) + " entries";
+        return false;
+    }
+    const bool has_uv = in.uvs != nullptr;
+    if (has_uv && !in.uv_indices && in.num_uvs != ni) { err = "polygons: face-varying uvs need one pair per face vertex"; return false; }
+
+    // Range checks, index-parallel.
+    const int kc = parallel_chunks(ni, nt);
+    std::vector<char> bad_v((size_t)kc, 0), bad_uv((size_t)kc, 0);
+    parallel_for(ni, nt, [&](size_t b, size_t e, int c) {
+        for (size_t i = b; i < e; ++i) {
+            if (in.indices[i] < 0 || (size_t)in.indices[i] >= nv) bad_v[(size_t)c] = 1;
+            if (has_uv && in.uv_indices && (in.uv_indices[i] < 0 || (size_t)in.uv_indices[i] >= in.num_uvs)) bad_uv[(size_t)c] = 1;
+        }
+    });
+    for (char x : bad_v) if (x) { err = "polygons: face vertex index out of range"; return false; }
+    for (char x : bad_uv) if (x) { err = "polygons: uv index out of range"; return false; }
+
+    const size_t ntri = t_off[(size_t)k];
+    mesh.faces.resize(ntri);
+    if (has_uv) mesh.face_uvs.resize(ntri);
+    if (keep_face_ids) mesh.face_ids.resize(ntri);
+    parallel_for(np, nt, [&](size_t b, size_t e, int c) {
+        ClipScratch sc;
+        std::vector<int> loc;
+        size_t corner = c_off[(size_t)c], tri = t_off[(size_t)c];
+        for (size_t i = b; i < e; ++i) {
+            const int n = in.counts[i];
+            const int* idx = in.indices + corner;
+            if (n >= 3) {
+                loc.resize(3 * ((size_t)n - 2));
+                triangulate_one(mesh.verts.data(), idx, n, mode, sc, loc.data());
+                for (size_t t = 0; t < loc.size(); t += 3, ++tri) {
+                    mesh.faces[tri] = Tri{idx[loc[t]], idx[loc[t + 1]], idx[loc[t + 2]]};
+                    if (has_uv) {
+                        for (int j = 0; j < 3; ++j) {
+                            const size_t s = corner + (size_t)loc[t + j];
+                            const size_t u = in.uv_indices ? (size_t)in.uv_indices[s] : s;
+                            mesh.face_uvs[tri][2 * j] = (T)in.uvs[2 * u];
+                            mesh.face_uvs[tri][2 * j + 1] = (T)in.uvs[2 * u + 1];
+                        }
+                    }
+                    if (keep_face_ids) mesh.face_ids[tri] = (int)i;
+                }
+            }
+            corner += (size_t)n;
+        }
+    });
+    return true;
+}
+
+template bool triangulate_polygons(Mesh&, const PolygonInput&, Triangulation, bool, std::string&, int);
+template bool triangulate_polygons(MeshF&, const PolygonInput&, Triangulation, bool, std::string&, int);
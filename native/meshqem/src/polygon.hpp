@@ -0,0 +1,42 @@
+// polygon.hpp — USD-style polygon ingestion: faceVertexCounts/Indices to triangles.
+//
+// Mesh is triangle-only. triangulate_polygons() takes a UsdGeomMesh topology as-is and cuts
+// it into Mesh::faces, so callers (the Python bindings, CAD importers) no longer triangulate
+// quads and n-gons or expand face-varying UVs themselves:
+// - Fan: (0, i, i+1) per polygon, matching USD's own renderer triangulation; exact for
+//   convex polygons.
+// - EarClip: triangles lie inside the polygon also when it is concave. Each polygon is
+//   projected onto the plane of its Newell normal; quads pick the diagonal through a reflex
+//   corner, larger polygons are ear-clipped. Polygons that are self-intersecting or
+//   degenerate still produce count-2 triangles (clipping falls back to the next corner).
+// Both emit count-2 triangles per polygon, in polygon order, so the output is identical
+// for any thread count. Polygons with fewer than 3 corners are invalid in USD and produce
+// none.
+//
+#pragma once
+#include "mesh.hpp"
+#include <cstddef>
+#include <string>
+
+enum class Triangulation { Fan, EarClip };
+
+// Polygon topology and optional UVs, referencing caller-owned arrays.
+struct PolygonInput {
+    const int*    counts = nullptr;      // faceVertexCounts, num_polys entries
+    size_t        num_polys = 0;
+    const int*    indices = nullptr;     // faceVertexIndices, sum(counts) entries
+    size_t        num_indices = 0;
+    const double* uvs = nullptr;         // (u,v) pairs or nullptr; without uv_indices one per corner
+    size_t        num_uvs = 0;           //   (face-varying), so num_uvs must equal num_indices
+    const int*    uv_indices = nullptr;  // indexed primvar: per-corner index into uvs (pass `indices`
+                                         //   for vertex-interpolated UVs), or nullptr
+};
+
+// Triangulate `in` over the points already in mesh.verts, replacing mesh.faces. Fills
+// mesh.face_uvs from in.uvs when given, and mesh.face_ids with each triangle's source polygon
+// when keep_face_ids is set (both cleared otherwise). Indices are range-checked.
+// On failure, returns false, leaves mesh.faces empty and writes a message to `err`.
+// Instantiated for Mesh and MeshF (projection and ear tests run in double for both).
+template <class T>
+bool triangulate_polygons(MeshT<T>& mesh, const PolygonInput& in, Triangulation mode, bool keep_face_ids,
+                          std::string& err, int threads = 1);
@@ -0,0 +1,43 @@
+// progressive.cpp — Prefix replay of a collapse log (see progressive.hpp).
+
+#include "progressive.hpp"
+#include <algorithm>
+
+size_t pm_prefix_for_faces(const CollapseRecord* log, size_t count, size_t base_faces, size_t target_faces) {
+    if (base_faces <= target_faces) return 0;
+    // faces_after never increases along the log, so the first record at or below the
+    // target is found by binary search.
+    const CollapseRecord* it = std::partition_point(log, log + count,
+        [target_faces](const CollapseRecord& r) { return (size_t)r.faces_after > target_faces; });
+    return it == log + count ? count : (size_t)(it - log) + 1;
+}
+
+void pm_extract_prefix(const Mesh& base, const CollapseRecord* log, size_t prefix, Mesh& out) {
+    const size_t nv = base.verts.size();
+    std::vector<Vec3> pos(base.verts);
+    std::vector<int> rep(nv);
+    for (size_t i = 0; i < nv; ++i) rep[i] = (int)i;
+    for (size_t i = 0; i < prefix; ++i) pos[log[i].u] = {log[i].x, log[i].y, log[i].z};
+    // Backward: when record i is visited, every later collapse of u is already resolved.
+    for (size_t i = prefix; i-- > 0; ) rep[log[i].v] = rep[log[i].u];
+
+    // Compact exactly like qem_simplify: surviving vertices keep their order.
+    std::vector<int> remap(nv, -1);
+    out.verts.clear(); out.faces.clear(); out.face_uvs.clear(); out.face_ids.clear();
+    for (size_t i = 0; i < nv; ++i) if (rep[i] == (int)i) { remap[i] = (int)out.verts.size(); out.verts.push_back(pos[i]); }
+    const bool has_uv = base.face_uvs.size() == base.faces.size() && !base.faces.empty();
+    const bool has_id = base.face_ids.size() == base.faces.size() && !base.faces.empty();
+    for (size_t fi = 0; fi < base.faces.size(); ++fi) {
+        const Tri& f = base.faces[fi];
+        int a = remap[rep[f.a]], b = remap[rep[f.b]], c = remap[rep[f.c]];
+        if (a == b || b == c || a == c) continue;
+        out.faces.push_back({a, b, c});
+        if (has_uv) out.face_uvs.push_back(base.face_uvs[fi]);
+        if (has_id) out.face_ids.push_back(base.face_ids[fi]);
+    }
+}
+
+void pm_extract(const ProgressiveMesh& pm, size_t target_faces, Mesh& out) {
+    const size_t n = pm_prefix_for_faces(pm.log.data(), pm.log.size(), pm.base.faces.size(), target_faces);
+    pm_extract_prefix(pm.base, pm.log.data(), n, out);
+}
@@ -0,0 +1,43 @@
+// progressive.hpp — Progressive-mesh collapse log and linear-time LOD extraction.
+//
+// qem_simplify(..., ProgressiveMesh* pm) records the base mesh it started from (after the
+// optional weld, with zero-area faces removed) and every collapse in order. Any prefix of
+// the log applied to the base reproduces the simplifier's state after that many collapses,
+// so a runtime can pick an arbitrary face count without re-running QEM:
+//   - positions: walk the prefix forward; the last record naming a vertex as `u` wins;
+//   - topology:  walk it backward with rep[v] = rep[u], which resolves chains of collapses
+//     in one pass; faces left with a repeated corner are dropped.
+// Both passes are linear in the prefix length plus the mesh size. The output is
+// bit-identical to qem_simplify stopped at the same point (vertex and face order included).
+// The log is stored in MQB files next to the base mesh (save_pm_bin in io_bin.hpp).
+//
+#pragma once
+#include "mesh.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// One edge collapse: vertex v merged into u, which moved to (x,y,z). 40 bytes, stored
+// verbatim (little-endian) in MQB files.
+struct CollapseRecord {
+    double  x, y, z;       // new position of u
+    int32_t v, u;          // removed vertex, surviving vertex (base mesh indices)
+    int32_t faces_after;   // face count once this collapse is applied
+    int32_t reserved;      // zero
+};
+static_assert(sizeof(CollapseRecord) == 40, "CollapseRecord is part of the MQB format");
+
+struct ProgressiveMesh {
+    Mesh base;                        // starting point of the log (face_uvs aligned if present)
+    std::vector<CollapseRecord> log;  // collapses in the order they were applied
+};
+
+// Number of records to apply so that at most `target_faces` faces remain (the shortest such
+// prefix, or the whole log if it never gets that low).
+size_t pm_prefix_for_faces(const CollapseRecord* log, size_t count, size_t base_faces, size_t target_faces);
+
+// Rebuild the mesh after the first `prefix` records of `log` into `out`.
+void pm_extract_prefix(const Mesh& base, const CollapseRecord* log, size_t prefix, Mesh& out);
+
+// Convenience: rebuild the level with at most `target_faces` faces.
+void pm_extract(const ProgressiveMesh& pm, size_t target_faces, Mesh& out);
@@ -9,18 +9,38 @@
 //       verts:  List[(x,y,z)]              顶点坐标列表
 //       faces:  List[(i,j,k)]              三角形索引列表（0-based）
 //       face_uvs: Optional[List[(u0,v0,u1,v1,u2,v2)]]  每面 3 个顶点的 UV
-//       ratio / target_faces / max_collapses / time_limit / progress_interval
+//       ratio / target_faces / max_collapses / time_limit / progress_interval / threads
 //   - 返回：
 //       (new_verts, new_faces, new_face_uvs_or_None)
 //
+// 另外还暴露了 simplify_arrays：参数/返回值都是 NumPy 数组（也接受 USD Vt 数组等
+// 支持 buffer protocol 的对象），整块拷贝进 Mesh，不逐元素转换 Python 对象，
+// 返回的数组直接接管 C++ 结果缓冲区（零拷贝）。两个入口在 qem_simplify 期间都会释放 GIL。
+// simplify_batch 则一次接收多个 mesh，在 C++ 线程池上并行简化。
+// simplify_lods 对同一个 mesh 只做一次初始化，一次折叠过程中依次产出多个 LOD。
+// simplify_batch 使用一个模块级的内容哈希结果缓存（set_cache_limit 设置上限，默认关闭），
+// 同一批内容相同的 mesh（实例化引用）总是只简化一次。
+// triangulate_polygons / simplify_polygons 直接接收 USD 的 faceVertexCounts / faceVertexIndices
+// 与 face-varying UV，在 C++ 内并行三角化，可返回每个三角形对应的源多边形编号（face_ids）。
+//
 // 对于 C++/pybind11 初学者：下面会对每一行做中文注释，帮你理解整体流程。
 //======================================================================
 
 #include "mesh.hpp"          // 引入本项目定义的 Mesh / Vec3 / Tri 等结构和与几何相关的声明
 #include "qem.hpp"           // 引入 QEM 简化算法相关的声明（SimplifyOptions, SimplifyReport, qem_simplify 等）
+#include "batch.hpp"         // 批量简化接口 qem_simplify_batch（内部 work-stealing 线程池）
+#include "mesh_cache.hpp"    // 按内容哈希的结果缓存 MeshCache（LRU，线程安全）
+#include "polygon.hpp"       // USD 风格多边形（faceVertexCounts/Indices）三角化 triangulate_polygons
 
 #include <pybind11/pybind11.h>  // 引入 pybind11 的主头文件，提供和 Python 交互的 API
 #include <pybind11/stl.h>       // 引入 pybind11 对 STL 容器（std::vector/std::array 等）的自动转换支持
+#include <pybind11/numpy.h>     // 引入 pybind11 的 NumPy 支持（py::array / py::array_t），用于零拷贝的数组接口
+
+#include <cstdint>              // int32_t / int64_t
+#include <cstring>              // std::memcpy：同类型缓冲区整块拷贝
+#include <exception>            // std::exception_ptr：把进度回调里的 Python 异常带出 C++ 折叠循环
+#include <string>
+#include <type_traits>          // std::is_same：编译期判断是否可以直接 memcpy
 
 namespace py = pybind11;        // 给 pybind11 起一个简短别名 py，方便后面书写
 
@@ -40,6 +60,7 @@ namespace py = pybind11;        // 给 pybind11 起一个简短别名 py，方
 //   max_collapses  : int                                   最多允许的折叠次数
 //   time_limit     : double                                单个 mesh 的时间上限
 //   progress_interval : int                                每多少次折叠输出一次进度
+//   threads        : int                                   初始化阶段线程数（<=0 表示全部硬件线程）
 // 返回值：
 //   py::tuple（三元组）：(out_verts, out_faces, out_face_uvs_or_None)
 //======================================================================
@@ -52,7 +73,8 @@ static py::tuple simplify_with_uv(
     int target_faces,                                  // 目标面数（绝对值）
     int max_collapses,                                 // 最多折叠次数
     double time_limit,                                 // 时间上限（秒）
-    int progress_interval)                             // 输出进度的间隔（多少次折叠打印一次）
+    int progress_interval,                             // 输出进度的间隔（多少次折叠打印一次）
+    int threads)                                       // 建图/初始化阶段使用的线程数（<=0 表示全部硬件线程）
 {
     Mesh mesh;                                         // 创建一个 Mesh 实例，用于传给 C++ QEM 简化核心
     mesh.verts.reserve(verts.size());                  // 预先为 mesh.verts 分配和输入顶点数量相同的容量，避免 push_back 反复扩容
@@ -90,6 +112,7 @@ static py::tuple simplify_with_uv(
     opt.max_collapses = max_collapses;             // 设置最多允许的折叠次数；当 <=0 时由算法内部推导
     opt.time_limit = time_limit;                   // 设置时间上限；<=0 通常表示不限制
     opt.progress_interval = progress_interval;     // 设置每隔多少次折叠输出一次进度（打印在 C++ 侧的日志里）
+    opt.threads = threads;                         // 设置初始化阶段（Quadric/邻接/堆构建）的线程数
 
     //======================= 调用 QEM 简化核心 ==========================
     // SimplifyReport 用于承载算法的统计信息（比如最终面数/折叠次数等），
@@ -97,7 +120,10 @@ static py::tuple simplify_with_uv(
     //====================================================================
 
     SimplifyReport rep;                            // 创建一个报告对象，用于接收统计信息
-    qem_simplify(mesh, opt, rep);                  // 调用 C++ 的 QEM 简化核心，对 mesh 进行原地简化
+    {
+        py::gil_scoped_release release;            // 简化期间释放 GIL：纯 C++ 计算不碰 Python 对象，其他 Python 线程可并发运行
+        qem_simplify(mesh, opt, rep);              // 调用 C++ 的 QEM 简化核心，对 mesh 进行原地简化
+    }                                              // 离开作用域时自动重新获取 GIL
 
     //======================= 把结果拷贝回 Python 友好的结构 =============
     // 这里我们把 mesh.verts / mesh.faces 转回成 std::vector<std::array<...>>，
@@ -130,6 +156,572 @@ static py::tuple simplify_with_uv(
     }
 }
 
+//======================================================================
+// NumPy 数组接口的辅助函数
+//
+// Mesh 的 Vec3 / Tri / UV triplet 在内存里分别就是连续的 3 个 double、3 个 int、
+// 6 个 double（MeshF 为 float），可以和形状为 (N,3) / (N,3) / (N,6) 的 C 连续数组一一对应：
+//   - 输入：同 dtype 时整块 memcpy；float32 / int64 等在 C++ 里一次循环转换；
+//     其他 dtype 交给 NumPy 的 forcecast 转换。全程不创建逐元素的 Python 对象。
+//   - 输出：把结果 std::vector 移动到堆上，由 py::capsule 管理生命周期，
+//     NumPy 数组直接指向这块内存，不再拷贝。
+//======================================================================
+
+static_assert(sizeof(Vec3) == 3 * sizeof(double), "Vec3 must be 3 packed doubles");
+static_assert(sizeof(Vec3f) == 3 * sizeof(float), "Vec3f must be 3 packed floats");
+static_assert(sizeof(Tri) == 3 * sizeof(int), "Tri must be 3 packed ints");
+static_assert(sizeof(int) == sizeof(int32_t), "face indices are exchanged as int32");
+
+// 检查数组形状为 (N, cols) 或长度为 N*cols 的一维数组，返回 N；否则抛出 ValueError。
+static size_t rows_of(const py::array& a, size_t cols, const char* name) {
+    if (a.ndim() == 2 && (size_t)a.shape(1) == cols) return (size_t)a.shape(0);
+    if (a.ndim() == 1 && (size_t)a.shape(0) % cols == 0) return (size_t)a.shape(0) / cols;
+    throw py::value_error(std::string(name) + ": expected an array of shape (N, " + std::to_string(cols) + ")");
+}
+
+// 把 a 的元素（按 S 类型解释，必要时先转成 C 连续）写入 dst[0..count)。
+template <class D, class S>
+static void copy_as(const py::array& a, D* dst, size_t count) {
+    auto src = py::array_t<S, py::array::c_style | py::array::forcecast>::ensure(a);  // 已是 C 连续同 dtype 时不拷贝
+    if (!src) throw py::type_error("cannot read array data");                         // ensure() 失败时已清除 Python 错误，这里重新报告
+    const S* p = src.data();
+    if (std::is_same<D, S>::value) std::memcpy(dst, p, count * sizeof(D));          // 同类型：一次整块拷贝
+    else for (size_t i = 0; i < count; ++i) dst[i] = (D)p[i];                        // 不同类型：一次 C++ 循环转换
+}
+
+// 读取浮点数组到 D（double 或 float）：与 D 同 dtype 时直接 memcpy，float32/float64 之间
+// 在 C++ 中转换，其余 dtype 由 NumPy 转成 float64。
+template <class D>
+static void read_reals(const py::array& a, D* dst, size_t count) {
+    if (py::isinstance<py::array_t<float>>(a)) copy_as<D, float>(a, dst, count);
+    else copy_as<D, double>(a, dst, count);
+}
+
+// 读取索引数组（int32 直接 memcpy，int64 在 C++ 中转换，其余 dtype 由 NumPy 转成 int32）。
+static void read_ints(const py::array& a, int* dst, size_t count) {
+    if (py::isinstance<py::array_t<int64_t>>(a)) copy_as<int, int64_t>(a, dst, count);
+    else copy_as<int, int32_t>(a, dst, count);
+}
+
+// 把 std::vector<Elem> 的所有权交给一个二维 NumPy 数组 (size, cols)，元素类型为 S（零拷贝）。
+template <class S, class Elem>
+static py::array steal_rows(std::vector<Elem>&& v, size_t cols) {
+    static_assert(sizeof(Elem) % sizeof(S) == 0, "element must be a packed row of S");
+    auto* owned = new std::vector<Elem>(std::move(v));                                          // 移动到堆上，数据指针不变
+    py::capsule owner(owned, [](void* p) { delete static_cast<std::vector<Elem>*>(p); });       // 数组被回收时释放 vector
+    return py::array_t<S>({(py::ssize_t)owned->size(), (py::ssize_t)cols},                       // 形状 (N, cols)
+                          {(py::ssize_t)sizeof(Elem), (py::ssize_t)sizeof(S)},                   // 行步长 / 列步长（字节）
+                          reinterpret_cast<const S*>(owned->data()), owner);                     // 指向 vector 数据，并由 capsule 持有
+}
+
+// 从数组类对象构造 Mesh / MeshF：verts (N,3) 浮点、faces (M,3) 整数、face_uvs 为 None 或 (M,6) 浮点。
+// 与 list 版本不同：索引越界会抛出 ValueError，而不是在 C++ 内部越界访问。
+template <class T>
+static void mesh_from_arrays(py::object verts_obj, py::object faces_obj, py::object face_uvs_obj, MeshT<T>& mesh) {
+    py::array verts = py::array::ensure(verts_obj);    // 转成 py::array 视图（ndarray 本身不拷贝）
+    py::array faces = py::array::ensure(faces_obj);
+    if (!verts || !faces) throw py::type_error("verts/faces must be array-like (NumPy or buffer protocol)");
+
+    const size_t nv = rows_of(verts, 3, "verts");
+    const size_t nf = rows_of(faces, 3, "faces");
+    mesh.clear();
+    mesh.verts.resize(nv);
+    mesh.faces.resize(nf);
+    read_reals(verts, reinterpret_cast<T*>(mesh.verts.data()), nv * 3);          // 整块读入顶点
+    read_ints(faces, reinterpret_cast<int*>(mesh.faces.data()), nf * 3);         // 整块读入索引
+    for (const auto& f : mesh.faces) {                                           // 先做一次廉价的越界检查
+        if (f.a < 0 || f.b < 0 || f.c < 0 || (size_t)f.a >= nv || (size_t)f.b >= nv || (size_t)f.c >= nv)
+            throw py::value_error("faces: vertex index out of range");
+    }
+
+    if (!face_uvs_obj.is_none()) {                     // 可选 UV：长度与 faces 一致时才携带，与 list 版本语义相同
+        py::array uvs = py::array::ensure(face_uvs_obj);
+        if (!uvs) throw py::type_error("face_uvs must be array-like or None");
+        if (rows_of(uvs, 6, "face_uvs") == nf) {
+            mesh.face_uvs.resize(nf);
+            read_reals(uvs, reinterpret_cast<T*>(mesh.face_uvs.data()), nf * 6);
+        }
+    }
+}
+
+// 把简化结果交给 NumPy：(verts (N,3), faces (M,3) int32, face_uvs (M,6) 或 None)，
+// 浮点数组为 float64（Mesh）或 float32（MeshF）。
+template <class T>
+static py::tuple mesh_to_arrays(MeshT<T>&& mesh) {
+    bool has_uv = !mesh.face_uvs.empty() && mesh.face_uvs.size() == mesh.faces.size();
+    py::array out_verts = steal_rows<T>(std::move(mesh.verts), 3);               // 结果缓冲区直接交给 NumPy
+    py::array out_faces = steal_rows<int32_t>(std::move(mesh.faces), 3);
+    if (has_uv) return py::make_tuple(out_verts, out_faces, steal_rows<T>(std::move(mesh.face_uvs), 6));
+    return py::make_tuple(out_verts, out_faces, py::none());
+}
+
+// precision 参数："float64" / "float32" / "auto"（verts 为 float32 时用 float32）。
+// 返回 true 表示用 MeshF：顶点/UV 以 float 存储、float32 输入整块 memcpy、结果为 float32 数组；
+// quadric 与折叠代价仍以 double 计算。其他字符串抛 ValueError。
+static bool use_float32(const std::string& precision, py::object verts_obj) {
+    if (precision == "float64") return false;
+    if (precision == "float32") return true;
+    if (precision == "auto") {
+        py::array verts = py::array::ensure(verts_obj);
+        return verts && py::isinstance<py::array_t<float>>(verts);
+    }
+    throw py::value_error("precision: expected \"float64\", \"float32\" or \"auto\", got \"" + precision + "\"");
+}
+
+// "qem" / "cluster" -> SimplifyMethod；其他字符串抛 ValueError
+static SimplifyMethod parse_method(const std::string& s) {
+    if (s == "qem") return SimplifyMethod::Qem;
+    if (s == "cluster") return SimplifyMethod::Cluster;
+    throw py::value_error("method: expected \"qem\" or \"cluster\", got \"" + s + "\"");
+}
+
+// "optimal" / "midpoint" / "endpoint" -> Placement；其他字符串抛 ValueError
+static Placement parse_placement(const std::string& s) {
+    if (s == "optimal") return Placement::Optimal;
+    if (s == "midpoint") return Placement::Midpoint;
+    if (s == "endpoint") return Placement::Endpoint;
+    throw py::value_error("placement: expected \"optimal\", \"midpoint\" or \"endpoint\", got \"" + s + "\"");
+}
+
+// SimplifyReport -> Python dict
+static py::dict stats_to_dict(const SimplifyStats& s) {
+    py::dict d;                                    // 各阶段耗时（秒）与热路径计数器，见 qem.hpp 中 SimplifyStats
+    d["t_quadrics"] = s.t_quadrics;
+    d["t_adjacency"] = s.t_adjacency;
+    d["t_heap_init"] = s.t_heap_init;
+    d["t_collapse"] = s.t_collapse;
+    d["t_compact"] = s.t_compact;
+    d["collapses"] = s.collapses;
+    d["heap_pushes"] = s.heap_pushes;
+    d["stale_pops"] = s.stale_pops;
+    d["solve_fallbacks"] = s.solve_fallbacks;
+    d["degenerate_faces"] = s.degenerate_faces;
+    d["welded_verts"] = s.welded_verts;
+    d["boundary_edges"] = s.boundary_edges;
+    d["seam_edges"] = s.seam_edges;
+    d["flip_rejects"] = s.flip_rejects;
+    d["link_rejects"] = s.link_rejects;
+    d["t_weld"] = s.t_weld;
+    d["peak_heap"] = s.peak_heap;
+    d["t_partition"] = s.t_partition;              // 分块模式：分块/提取/拼接耗时
+    d["t_clusters"] = s.t_clusters;                // 分块模式：各块并行折叠的墙钟时间
+    d["clusters"] = s.clusters;                    // 分块模式下的块数（0 = 串行）
+    d["t_grid"] = s.t_grid;                        // 聚类模式：网格尺寸估计与顶点分格耗时
+    d["time_limited"] = s.time_limited;
+    d["cancelled"] = s.cancelled;                  // 进度回调返回 False（或抛出异常）而提前结束
+    d["error_limited"] = s.error_limited;          // 因 max_error（最便宜的折叠代价超过上限）而停止
+    return d;
+}
+
+static py::dict report_to_dict(const SimplifyReport& rep, bool with_stats = false) {
+    py::dict d;
+    d["faces_before"] = rep.faces_before;
+    d["faces_after"] = rep.faces_after;
+    d["verts_before"] = rep.verts_before;
+    d["verts_after"] = rep.verts_after;
+    d["scratch_bytes"] = rep.scratch_bytes;        // 本次运行临时缓冲区的峰值字节数
+    d["from_cache"] = rep.from_cache;              // 结果来自缓存（或同批次的相同 mesh），未执行 QEM
+    d["final_error"] = rep.final_error;            // 已执行折叠中最大代价的平方根（网格单位）
+    if (with_stats) d["stats"] = stats_to_dict(rep.stats);  // 仅在 collect_stats 打开时附带
+    return d;
+}
+
+// Python 进度回调：每 progress_interval 次折叠，在重新获取 GIL 后调用 progress(dict)，
+// dict 含 collapses / faces / target / elapsed（秒）；返回 False 取消本次简化，None/True 继续。
+// 回调抛出的异常同样会取消运行，并在回到 Python 之前原样重新抛出。
+struct PyProgress {
+    py::object fn;
+    std::exception_ptr error;
+
+    explicit PyProgress(py::object f) : fn(std::move(f)) {}
+    void attach(SimplifyOptions& opt) {
+        if (fn.is_none()) return;                  // 未提供回调：保持 stderr 进度行
+        opt.progress = [this](const SimplifyProgress& p) {
+            py::gil_scoped_acquire gil;            // 折叠循环运行在释放 GIL 的状态下
+            try {
+                py::dict d;
+                d["collapses"] = p.collapses;
+                d["faces"] = p.faces;
+                d["target"] = p.target;
+                d["elapsed"] = p.elapsed;
+                py::object r = fn(d);
+                return r.is_none() || (bool)py::bool_(r);
+            } catch (...) {
+                error = std::current_exception();
+                return false;
+            }
+        };
+    }
+    void rethrow() { if (error) std::rethrow_exception(error); }   // 需在持有 GIL 时调用
+};
+
+//======================================================================
+// 函数：simplify_arrays
+// 作用：
+//   - 与 simplify_with_uv 相同的简化逻辑，但输入/输出都是 NumPy 数组；
+//   - verts: (N,3) float64/float32；faces: (M,3) int32/int64；face_uvs: None 或 (M,6) 浮点；
+//     也接受扁平的一维数组，以及实现 buffer protocol 的对象（如 pxr.Vt.Vec3fArray）；
+//   - 返回 (new_verts (N',3) float64, new_faces (M',3) int32, new_face_uvs (M',6) float64 或 None)；
+//     collect_stats=True 时额外返回第四项 report 字典（含 "stats" 子字典）；
+//   - precision="float32"（或 "auto" 且 verts 为 float32）时以 MeshF 运行，结果数组为 float32。
+//======================================================================
+
+// 以 MeshT<T> 读入、简化并返回（simplify_arrays 按 precision 选择 T）。
+template <class T>
+static py::tuple simplify_arrays_as(py::object verts_obj, py::object faces_obj, py::object face_uvs_obj,
+                                    SimplifyOptions& opt, py::object progress) {
+    MeshT<T> mesh;
+    mesh_from_arrays(verts_obj, faces_obj, face_uvs_obj, mesh);
+    PyProgress hook(progress);
+    hook.attach(opt);
+
+    SimplifyReport rep;
+    {
+        py::gil_scoped_release release;                // 释放 GIL，允许多个 Python 线程同时简化不同的 mesh
+        qem_simplify(mesh, opt, rep);
+    }
+    hook.rethrow();
+    py::tuple arrs = mesh_to_arrays(std::move(mesh));
+    if (!opt.collect_stats) return arrs;
+    return py::make_tuple(arrs[0], arrs[1], arrs[2], report_to_dict(rep, true));
+}
+
+static py::tuple simplify_arrays(
+    py::object verts_obj,                              // 顶点数组（任意支持 buffer protocol 的对象）
+    py::object faces_obj,                              // 三角面索引数组
+    py::object face_uvs_obj,                           // 每面 UV triplet 数组，或 None
+    double ratio,
+    int target_faces,
+    int max_collapses,
+    double time_limit,
+    int progress_interval,
+    int threads,
+    bool collect_stats,                                // 是否统计各阶段耗时/计数器
+    double weld_eps,                                   // >=0 时先焊接距离不超过 weld_eps 的顶点（三角汤输入）
+    int partitions,                                    // >1 时按空间分块并行折叠（<0 = 每线程一块）
+    const std::string& method,                         // "qem"（默认）或 "cluster"（网格顶点聚类，快速预览）
+    py::object progress,                               // None 或进度回调（见 PyProgress）
+    const std::string& precision,                      // "float64"（默认）/ "float32" / "auto"
+    double max_error,                                  // >=0 时最便宜的折叠代价超过 max_error^2 即停止
+    bool max_error_relative,                           // max_error 按包围盒对角线的比例解释
+    const std::string& placement,                      // 折叠后顶点位置："optimal"（默认）/ "midpoint" / "endpoint"
+    bool reorder,                                      // 输出按顶点缓存友好顺序重排（Tipsify 面序 + 首次使用顶点序）
+    double boundary_weight,                            // >0 时沿开放边界加惩罚平面，防止边界收缩/开裂
+    double seam_weight,                                // >0 时沿 face-varying UV 接缝加惩罚平面（需要 face_uvs）
+    bool guard,                                        // 拒绝会翻转三角形或破坏 link condition 的折叠
+    bool deterministic)                                // 结果与线程数无关（partitions<0 时按面数定块数）
+{
+    SimplifyOptions opt;
+    opt.ratio = ratio;
+    opt.target_faces = target_faces;
+    opt.max_collapses = max_collapses;
+    opt.time_limit = time_limit;
+    opt.progress_interval = progress_interval;
+    opt.threads = threads;
+    opt.collect_stats = collect_stats;
+    opt.weld_eps = weld_eps;
+    opt.partitions = partitions;
+    opt.deterministic = deterministic;
+    opt.method = parse_method(method);
+    opt.max_error = max_error;
+    opt.max_error_relative = max_error_relative;
+    opt.placement = parse_placement(placement);
+    opt.reorder = reorder;
+    opt.boundary_weight = boundary_weight;
+    opt.seam_weight = seam_weight;
+    opt.guard = guard;
+    if (use_float32(precision, verts_obj)) return simplify_arrays_as<float>(verts_obj, faces_obj, face_uvs_obj, opt, progress);
+    return simplify_arrays_as<double>(verts_obj, faces_obj, face_uvs_obj, opt, progress);
+}
+
+//======================================================================
+// 函数：simplify_lods
+// 作用：
+//   - 一次初始化（quadric / 邻接 / 堆）、一趟折叠生成整条 LOD 链；
+//   - targets: list，元素为 float 时表示面数比例，为 int 时表示绝对目标面数，例如 [0.5, 0.25, 0.1]；
+//   - 返回 list[(new_verts, new_faces, new_face_uvs_or_None)]，顺序与 targets 一致。
+//======================================================================
+
+template <class T>
+static py::list simplify_lods_as(py::object verts_obj, py::object faces_obj, py::object face_uvs_obj,
+                                 const std::vector<LodTarget>& lod_targets, SimplifyOptions& opt, py::object progress) {
+    MeshT<T> mesh;
+    mesh_from_arrays(verts_obj, faces_obj, face_uvs_obj, mesh);
+    PyProgress hook(progress);
+    hook.attach(opt);
+
+    std::vector<MeshT<T>> lods;
+    SimplifyReport rep;
+    {
+        py::gil_scoped_release release;                // 整条 LOD 链计算期间释放 GIL
+        qem_simplify_lods(mesh, lod_targets, opt, lods, rep);
+    }
+    hook.rethrow();
+    py::list out;
+    for (auto& l : lods) out.append(mesh_to_arrays(std::move(l)));
+    return out;
+}
+
+static py::list simplify_lods(
+    py::object verts_obj,
+    py::object faces_obj,
+    py::list targets,                                  // LOD 目标列表（比例或面数）
+    py::object face_uvs_obj,
+    int max_collapses,
+    double time_limit,
+    int progress_interval,
+    int threads,
+    double weld_eps,
+    py::object progress,                               // None 或进度回调，对整条 LOD 链生效
+    const std::string& precision,                      // 同 simplify_arrays
+    double max_error,                                  // 同 simplify_arrays，对整条 LOD 链生效
+    bool max_error_relative,
+    const std::string& placement,                      // 同 simplify_arrays
+    bool reorder,                                      // 同 simplify_arrays，对每个 LOD 生效
+    double boundary_weight, double seam_weight,        // 同 simplify_arrays
+    bool guard)
+{
+    std::vector<LodTarget> lod_targets;
+    for (py::handle t : targets) {
+        LodTarget lt;
+        if (py::isinstance<py::int_>(t)) lt.target_faces = t.cast<int>();  // int：绝对面数
+        else lt.ratio = t.cast<double>();                                  // float：比例
+        lod_targets.push_back(lt);
+    }
+
+    SimplifyOptions opt;
+    opt.max_collapses = max_collapses;
+    opt.time_limit = time_limit;
+    opt.progress_interval = progress_interval;
+    opt.threads = threads;
+    opt.weld_eps = weld_eps;
+    opt.max_error = max_error;
+    opt.max_error_relative = max_error_relative;
+    opt.placement = parse_placement(placement);
+    opt.reorder = reorder;
+    opt.boundary_weight = boundary_weight;
+    opt.seam_weight = seam_weight;
+    opt.guard = guard;
+    if (use_float32(precision, verts_obj)) return simplify_lods_as<float>(verts_obj, faces_obj, face_uvs_obj, lod_targets, opt, progress);
+    return simplify_lods_as<double>(verts_obj, faces_obj, face_uvs_obj, lod_targets, opt, progress);
+}
+
+//======================================================================
+// 函数：simplify_batch
+// 作用：
+//   - 一次调用简化多个 mesh，在 C++ 内部的 work-stealing 线程池上按面数从大到小调度；
+//   - meshes: list[dict]，每个 dict 至少包含 "verts" 与 "faces"（数组类对象），可选 "face_uvs"
+//     以及与 simplify_arrays 同名的参数键（ratio/target_faces/max_collapses/time_limit/
+//     progress_interval/threads），缺省键使用 SimplifyOptions 的默认值；
+//   - 返回 list[(new_verts, new_faces, new_face_uvs_or_None, report_dict)]，顺序与输入一致。
+// 所有输入在持有 GIL 时读入，整个批处理期间释放 GIL。
+// use_cache=True 时查询/写入模块级缓存 g_cache（跨调用保留，上限由 set_cache_limit 设置）。
+//======================================================================
+
+static MeshCache g_cache;                          // 模块级结果缓存，默认上限 0（关闭）
+
+static py::dict cache_info() {
+    py::dict d;
+    d["entries"] = g_cache.size();
+    d["bytes"] = g_cache.bytes();
+    d["hits"] = g_cache.hits();
+    d["misses"] = g_cache.misses();
+    return d;
+}
+
+static py::list simplify_batch(py::list meshes, int threads, bool use_cache) {
+    std::vector<BatchItem> items(meshes.size());
+    for (size_t i = 0; i < items.size(); ++i) {
+        py::dict d = meshes[i].cast<py::dict>();
+        py::object uvs = d.contains("face_uvs") ? py::object(d["face_uvs"]) : py::object(py::none());
+        mesh_from_arrays(d["verts"], d["faces"], uvs, items[i].mesh);
+        SimplifyOptions& opt = items[i].opt;
+        if (d.contains("ratio")) opt.ratio = d["ratio"].cast<double>();
+        if (d.contains("target_faces")) opt.target_faces = d["target_faces"].cast<int>();
+        if (d.contains("max_collapses")) opt.max_collapses = d["max_collapses"].cast<int>();
+        if (d.contains("time_limit")) opt.time_limit = d["time_limit"].cast<double>();
+        if (d.contains("progress_interval")) opt.progress_interval = d["progress_interval"].cast<int>();
+        if (d.contains("threads")) opt.threads = d["threads"].cast<int>();
+        if (d.contains("collect_stats")) opt.collect_stats = d["collect_stats"].cast<bool>();
+        if (d.contains("weld_eps")) opt.weld_eps = d["weld_eps"].cast<double>();
+        if (d.contains("partitions")) opt.partitions = d["partitions"].cast<int>();
+        if (d.contains("deterministic")) opt.deterministic = d["deterministic"].cast<bool>();
+        if (d.contains("method")) opt.method = parse_method(d["method"].cast<std::string>());
+        if (d.contains("max_error")) opt.max_error = d["max_error"].cast<double>();
+        if (d.contains("max_error_relative")) opt.max_error_relative = d["max_error_relative"].cast<bool>();
+        if (d.contains("placement")) opt.placement = parse_placement(d["placement"].cast<std::string>());
+        if (d.contains("reorder")) opt.reorder = d["reorder"].cast<bool>();
+        if (d.contains("boundary_weight")) opt.boundary_weight = d["boundary_weight"].cast<double>();
+        if (d.contains("seam_weight")) opt.seam_weight = d["seam_weight"].cast<double>();
+        if (d.contains("guard")) opt.guard = d["guard"].cast<bool>();
+    }
+    {
+        py::gil_scoped_release release;                // 整个批处理不需要 Python 对象
+        qem_simplify_batch(items, threads, use_cache ? &g_cache : nullptr);
+    }
+    py::list out;
+    for (auto& it : items) {
+        py::tuple arrs = mesh_to_arrays(std::move(it.mesh));
+        out.append(py::make_tuple(arrs[0], arrs[1], arrs[2], report_to_dict(it.rep, it.opt.collect_stats)));
+    }
+    return out;
+}
+
+//======================================================================
+// 函数：triangulate_polygons / simplify_polygons
+// 作用：
+//   - 直接接收 UsdGeomMesh 的拓扑：points (N,3)、faceVertexCounts (P,)、faceVertexIndices (K,)；
+//   - uvs：None 或 (K,2) face-varying UV；给出 uv_indices (K,) 时按索引取 uvs（indexed primvar，
+//     顶点插值的 UV 可直接传 faceVertexIndices 作为 uv_indices）；
+//   - triangulation："earclip"（默认，凹多边形也正确）或 "fan"（与 USD 渲染端一致，仅适合凸多边形）；
+//   - 三角化在 C++ 中按多边形并行完成，face_ids[i] 为第 i 个三角形来自的多边形编号，
+//     简化时与 face_uvs 一样随面删除/压缩。
+//======================================================================
+
+// "fan" / "earclip" -> Triangulation；其他字符串抛 ValueError
+static Triangulation parse_triangulation(const std::string& s) {
+    if (s == "fan") return Triangulation::Fan;
+    if (s == "earclip") return Triangulation::EarClip;
+    throw py::value_error("triangulation: expected \"fan\" or \"earclip\", got \"" + s + "\"");
+}
+
+// 一维整数数组 -> std::vector<int>（int64 在 C++ 中转换）
+static std::vector<int> ints_from(py::object obj, const char* name) {
+    py::array a = py::array::ensure(obj);
+    if (!a) throw py::type_error(std::string(name) + " must be array-like");
+    std::vector<int> v((size_t)a.size());
+    read_ints(a, v.data(), v.size());
+    return v;
+}
+
+// 在持有 GIL 时读入的多边形输入（数组整块拷贝），之后可在释放 GIL 的情况下三角化。
+struct PolygonArrays {
+    std::vector<int> counts, indices, uv_indices;
+    std::vector<double> uvs;
+    bool has_uv = false;
+    PolygonInput input() const {
+        PolygonInput in;
+        in.counts = counts.data(); in.num_polys = counts.size();
+        in.indices = indices.data(); in.num_indices = indices.size();
+        if (has_uv) { in.uvs = uvs.data(); in.num_uvs = uvs.size() / 2; }
+        if (has_uv && !uv_indices.empty()) in.uv_indices = uv_indices.data();
+        return in;
+    }
+};
+
+template <class T>
+static void polygons_from_arrays(py::object points_obj, py::object counts_obj, py::object indices_obj,
+                                 py::object uvs_obj, py::object uv_indices_obj, MeshT<T>& mesh, PolygonArrays& pa) {
+    py::array points = py::array::ensure(points_obj);
+    if (!points) throw py::type_error("points must be array-like (NumPy or buffer protocol)");
+    const size_t nv = rows_of(points, 3, "points");
+    mesh.clear();
+    mesh.verts.resize(nv);
+    read_reals(points, reinterpret_cast<T*>(mesh.verts.data()), nv * 3);
+    pa.counts = ints_from(counts_obj, "face_vertex_counts");
+    pa.indices = ints_from(indices_obj, "face_vertex_indices");
+    if (!uvs_obj.is_none()) {
+        py::array uvs = py::array::ensure(uvs_obj);
+        if (!uvs) throw py::type_error("uvs must be array-like or None");
+        pa.uvs.resize(rows_of(uvs, 2, "uvs") * 2);
+        read_reals(uvs, pa.uvs.data(), pa.uvs.size());
+        pa.has_uv = true;
+        if (!uv_indices_obj.is_none()) {
+            pa.uv_indices = ints_from(uv_indices_obj, "uv_indices");
+            if (pa.uv_indices.size() != pa.indices.size()) throw py::value_error("uv_indices: expected one entry per face vertex");
+        }
+    }
+}
+
+// face_ids 交给 NumPy：一维 int32 数组 (M,)，零拷贝；与 faces 不对齐时返回 None。
+static py::object ids_to_array(std::vector<int>&& ids, size_t nf) {
+    if (ids.empty() || ids.size() != nf) return py::none();
+    auto* owned = new std::vector<int>(std::move(ids));
+    py::capsule owner(owned, [](void* p) { delete static_cast<std::vector<int>*>(p); });
+    return py::array_t<int32_t>({(py::ssize_t)owned->size()}, {(py::ssize_t)sizeof(int)}, owned->data(), owner);
+}
+
+static py::tuple triangulate_polygons_py(
+    py::object points_obj, py::object counts_obj, py::object indices_obj,
+    py::object uvs_obj, py::object uv_indices_obj, const std::string& triangulation, int threads)
+{
+    Mesh mesh; PolygonArrays pa;
+    polygons_from_arrays(points_obj, counts_obj, indices_obj, uvs_obj, uv_indices_obj, mesh, pa);
+    const Triangulation mode = parse_triangulation(triangulation);
+    std::string err; bool ok;
+    {
+        py::gil_scoped_release release;                // 三角化期间释放 GIL
+        ok = triangulate_polygons(mesh, pa.input(), mode, true, err, threads);
+    }
+    if (!ok) throw py::value_error(err);
+    py::object ids = ids_to_array(std::move(mesh.face_ids), mesh.faces.size());
+    py::tuple arrs = mesh_to_arrays(std::move(mesh));
+    return py::make_tuple(arrs[0], arrs[1], arrs[2], ids);
+}
+
+template <class T>
+static py::tuple simplify_polygons_as(py::object points_obj, py::object counts_obj, py::object indices_obj,
+                                      py::object uvs_obj, py::object uv_indices_obj, Triangulation mode,
+                                      bool keep_face_ids, SimplifyOptions& opt, py::object progress) {
+    MeshT<T> mesh; PolygonArrays pa;
+    polygons_from_arrays(points_obj, counts_obj, indices_obj, uvs_obj, uv_indices_obj, mesh, pa);
+    PyProgress hook(progress);
+    hook.attach(opt);
+
+    SimplifyReport rep;
+    std::string err; bool ok;
+    {
+        py::gil_scoped_release release;                // 三角化 + 简化全程释放 GIL
+        ok = triangulate_polygons(mesh, pa.input(), mode, keep_face_ids, err, opt.threads);
+        if (ok) qem_simplify(mesh, opt, rep);
+    }
+    hook.rethrow();
+    if (!ok) throw py::value_error(err);
+    py::object ids = ids_to_array(std::move(mesh.face_ids), mesh.faces.size());
+    py::tuple arrs = mesh_to_arrays(std::move(mesh));
+    if (!opt.collect_stats) return py::make_tuple(arrs[0], arrs[1], arrs[2], ids);
+    return py::make_tuple(arrs[0], arrs[1], arrs[2], ids, report_to_dict(rep, true));
+}
+
+static py::tuple simplify_polygons(
+    py::object points_obj, py::object counts_obj, py::object indices_obj,
+    py::object uvs_obj, py::object uv_indices_obj, const std::string& triangulation,
+    double ratio, int target_faces, int max_collapses, double time_limit, int progress_interval,
+    int threads, bool collect_stats, double weld_eps, int partitions, const std::string& method,
+    bool keep_face_ids,                                // 是否返回每个结果三角形的源多边形编号
+    py::object progress,
+    const std::string& precision,                      // 同 simplify_arrays（按 points 的 dtype 判断 "auto"）
+    double max_error, bool max_error_relative,         // 同 simplify_arrays
+    const std::string& placement, bool reorder,
+    double boundary_weight, double seam_weight,        // 同 simplify_arrays
+    bool guard, bool deterministic)
+{
+    const Triangulation mode = parse_triangulation(triangulation);
+
+    SimplifyOptions opt;
+    opt.ratio = ratio;
+    opt.target_faces = target_faces;
+    opt.max_collapses = max_collapses;
+    opt.time_limit = time_limit;
+    opt.progress_interval = progress_interval;
+    opt.threads = threads;
+    opt.collect_stats = collect_stats;
+    opt.weld_eps = weld_eps;
+    opt.partitions = partitions;
+    opt.deterministic = deterministic;
+    opt.method = parse_method(method);
+    opt.max_error = max_error;
+    opt.max_error_relative = max_error_relative;
+    opt.placement = parse_placement(placement);
+    opt.reorder = reorder;
+    opt.boundary_weight = boundary_weight;
+    opt.seam_weight = seam_weight;
+    opt.guard = guard;
+    if (use_float32(precision, points_obj))
+        return simplify_polygons_as<float>(points_obj, counts_obj, indices_obj, uvs_obj, uv_indices_obj, mode, keep_face_ids, opt, progress);
+    return simplify_polygons_as<double>(points_obj, counts_obj, indices_obj, uvs_obj, uv_indices_obj, mode, keep_face_ids, opt, progress);
+}
+
 //======================================================================
 // PYBIND11_MODULE 宏块：定义一个名为 meshqem_py 的 Python 扩展模块
 //
@@ -153,6 +745,7 @@ PYBIND11_MODULE(meshqem_py, m) {   // 定义一个 Python 模块，模块名为
         py::arg("max_collapses") = -1,         // 参数 max_collapses，默认 -1（让算法内部按目标面数推导）
         py::arg("time_limit") = -1.0,          // 参数 time_limit，默认 -1.0（不设时间上限）
         py::arg("progress_interval") = 20000,  // 参数 progress_interval，默认 20000 次折叠打印一次进度
+        py::arg("threads") = 1,                // 参数 threads，默认 1（单线程初始化）；<=0 使用全部硬件线程
         R"doc(                                  // 下面是 Python 侧看到的文档字符串（多行），使用原始字符串 R"doc(... )doc" 书写更方便
 Simplify a triangle mesh using native C++ meshqem with optional face-varying UV triplets.
 
@@ -175,6 +768,8 @@ time_limit : float
     Per-mesh time limit in seconds; <=0 disables.
 progress_interval : int
     Emit C++ progress lines every N collapses (stderr).
+threads : int
+    Worker threads for the setup phase (quadrics, adjacency, heap); <=0 uses all cores.
 
 Returns
 -------
@@ -182,4 +777,292 @@ new_verts : List[(x,y,z)]
 new_faces : List[(i,j,k)]
 new_face_uvs_or_None : Optional[List[(u0,v0,u1,v1,u2,v2)]]
         )doc");                              // 文档字符串结束，m.def 调用结束
+
+    m.def(                                      // NumPy 版本：参数/返回值均为数组，简化期间释放 GIL
+        "simplify_arrays",
+        &simplify_arrays,
+        py::arg("verts"),
+        py::arg("faces"),
+        py::arg("face_uvs") = py::none(),
+        py::arg("ratio") = 0.5,
+        py::arg("target_faces") = -1,
+        py::arg("max_collapses") = -1,
+        py::arg("time_limit") = -1.0,
+        py::arg("progress_interval") = 20000,
+        py::arg("threads") = 1,
+        py::arg("collect_stats") = false,
+        py::arg("weld_eps") = -1.0,
+        py::arg("partitions") = 0,
+        py::arg("method") = "qem",
+        py::arg("progress") = py::none(),
+        py::arg("precision") = "float64",
+        py::arg("max_error") = -1.0,
+        py::arg("max_error_relative") = false,
+        py::arg("placement") = "optimal",
+        py::arg("reorder") = false,
+        py::arg("boundary_weight") = 0.0,
+        py::arg("seam_weight") = 0.0,
+        py::arg("guard") = true,
+        py::arg("deterministic") = false,
+        R"doc(
+Simplify a triangle mesh given as NumPy arrays (or any buffer-protocol object,
+e.g. pxr.Vt.Vec3fArray / Vt.IntArray). Inputs are read in bulk without per-element
+Python conversion; outputs are NumPy arrays that own the C++ result buffers.
+The GIL is released while simplifying, so several Python threads can run at once.
+
+Parameters
+----------
+verts : array_like, shape (N,3) or (3N,), float64 or float32
+faces : array_like, shape (M,3) or (3M,), int32 or int64 (0-based)
+face_uvs : Optional[array_like], shape (M,6)
+    Per-face UV triplets aligned with `faces`; carried along when the length matches.
+ratio, target_faces, max_collapses, time_limit, progress_interval, threads
+    Same meaning as in simplify_with_uv.
+collect_stats : bool
+    Also return a report dict with per-phase timings and counters under "stats".
+weld_eps : float
+    When >= 0, first weld vertices closer than this distance (0 = exact duplicates).
+    Use for triangle soup; faces that collapse in the weld are dropped with their UVs.
+partitions : int
+    > 1: split large meshes into this many spatial clusters, collapse them concurrently
+    (seams locked), then finish with one pass over the whole mesh; < 0: one cluster per
+    thread (see deterministic); 0: serial. Output is comparable to, not identical with, a
+    serial run.
+method : str
+    "qem" (edge collapse, default) or "cluster": uniform-grid vertex clustering, linear
+    time and much faster but coarser, with the face count only near the target. For
+    previews and distant proxies; ignores the collapse-loop options and partitions.
+progress : Optional[Callable[[dict], Optional[bool]]]
+    Called every progress_interval collapses (instead of the "[cpp] ..." stderr line) with
+    the GIL held and a dict {collapses, faces, target, elapsed}. Return False to cancel:
+    the result is the mesh reached so far and stats["cancelled"] is set. An exception
+    raised by the callback cancels the run and is re-raised from this call.
+precision : str
+    "float64" (default), "float32", or "auto" (float32 when verts is float32).
+    "float32" stores positions and UVs as float, halving their memory and reading
+    float32 input without conversion; quadrics and collapse costs are still computed
+    in double. Output arrays then are float32.
+max_error : float
+    When >= 0, also stop once the cheapest remaining collapse costs more than
+    max_error**2 (QEM cost: summed squared distances to the merged face planes), so
+    max_error is roughly a distance in mesh units. The face target still applies; pass
+    ratio=0 to stop on error alone. Ignored by method="cluster".
+max_error_relative : bool
+    Interpret max_error as a fraction of the bounding-box diagonal (e.g. 0.001).
+placement : str
+    Where a collapsed edge's vertex goes: "optimal" (default; the quadric minimizer, or
+    the cheapest of midpoint and endpoints where that is singular), "midpoint", or
+    "endpoint" (output positions are a subset of the input).
+reorder : bool
+    Emit faces in vertex-cache friendly (Tipsify) order and number vertices by first use,
+    for faster rendering and more local downstream passes. Unreferenced vertices are
+    dropped. Same mesh, different order; off by default so output order stays stable.
+boundary_weight : float
+    > 0: add a penalty plane along every open-boundary edge, this many times the weight of a
+    face plane (e.g. 100), so borders keep their outline instead of shrinking or cracking.
+    Counted in stats["boundary_edges"]. Ignored by method="cluster".
+seam_weight : float
+    > 0: the same along face-varying UV seams (edges whose two faces disagree on an
+    endpoint's UV), so seam vertices stay on the seam; needs face_uvs. UV values are still
+    carried with their faces, not re-interpolated. Counted in stats["seam_edges"].
+guard : bool
+    Refuse collapses that would flip a face or make an edge non-manifold (the link
+    condition), checked on the faces around the edge's two endpoints. A refused edge is
+    retried later at a raised cost; counted in stats["flip_rejects"] / ["link_rejects"].
+    On by default; False restores the unguarded behaviour. Ignored by method="cluster".
+deterministic : bool
+    Guarantee the same output for any `threads` value and scheduling: with partitions < 0
+    the cluster count then comes from the face count (one per 131072 faces, at most 64)
+    instead of the thread count. Every other setting is already thread-count independent;
+    time_limit and cancelling stop at a timing-dependent point either way.
+
+Returns
+-------
+new_verts : ndarray (N',3) float64 (float32 with precision float32)
+new_faces : ndarray (M',3) int32
+new_face_uvs_or_None : Optional[ndarray (M',6) float64 (float32 with precision float32)]
+report : dict, only when collect_stats is True
+        )doc");
+
+    m.def(                                      // LOD 链版本：一次初始化、一趟折叠产出多个 LOD
+        "simplify_lods",
+        &simplify_lods,
+        py::arg("verts"),
+        py::arg("faces"),
+        py::arg("targets"),
+        py::arg("face_uvs") = py::none(),
+        py::arg("max_collapses") = -1,
+        py::arg("time_limit") = -1.0,
+        py::arg("progress_interval") = 20000,
+        py::arg("threads") = 1,
+        py::arg("weld_eps") = -1.0,
+        py::arg("progress") = py::none(),
+        py::arg("precision") = "float64",
+        py::arg("max_error") = -1.0,
+        py::arg("max_error_relative") = false,
+        py::arg("placement") = "optimal",
+        py::arg("reorder") = false,
+        py::arg("boundary_weight") = 0.0,
+        py::arg("seam_weight") = 0.0,
+        py::arg("guard") = true,
+        R"doc(
+Build a LOD chain in one pass: quadrics, adjacency and the heap are built once, and
+the collapse loop emits a compacted snapshot each time it crosses a target.
+
+Parameters
+----------
+verts, faces
+    As in simplify_arrays.
+targets : list
+    One entry per LOD: a float is a face ratio, an int an absolute face count,
+    e.g. [0.5, 0.25, 0.1]. Any order.
+face_uvs
+    As in simplify_arrays.
+max_collapses, time_limit, progress_interval, threads, weld_eps, progress, precision,
+max_error, max_error_relative, placement, reorder, boundary_weight, seam_weight, guard
+    As in simplify_arrays; the caps apply to the whole chain. After a cancel, or once
+    max_error is reached, the remaining levels equal the last state reached.
+
+Returns
+-------
+list of (new_verts, new_faces, new_face_uvs_or_None), one per target, in input order.
+        )doc");
+
+    m.def(                                      // 批量版本：一次简化多个 mesh（内部线程池并行）
+        "simplify_batch",
+        &simplify_batch,
+        py::arg("meshes"),
+        py::arg("threads") = 0,
+        py::arg("use_cache") = true,
+        R"doc(
+Simplify many meshes in one call on an internal work-stealing thread pool.
+Meshes are scheduled largest-first; the GIL is released for the whole batch.
+
+Parameters
+----------
+meshes : list[dict]
+    Each dict has "verts" and "faces" (array-like, as in simplify_arrays), an optional
+    "face_uvs", and optional per-mesh option keys: ratio, target_faces, max_collapses,
+    time_limit, progress_interval, threads (setup threads for that mesh; default 1),
+    collect_stats (add a "stats" dict to that mesh's report), weld_eps, partitions, method,
+    max_error, max_error_relative, placement, reorder, boundary_weight, seam_weight, guard,
+    deterministic.
+threads : int
+    Pool size; <=0 uses all hardware threads.
+use_cache : bool
+    Look results up in (and add them to) the module's content-hash cache; see
+    set_cache_limit. Identical meshes within one batch are simplified once either way.
+
+Returns
+-------
+list of (new_verts, new_faces, new_face_uvs_or_None, report) in input order, where
+report is a dict with faces_before/faces_after/verts_before/verts_after/scratch_bytes/from_cache/
+final_error.
+        )doc");
+
+    m.def(                                      // USD 多边形输入：只三角化，不简化
+        "triangulate_polygons",
+        &triangulate_polygons_py,
+        py::arg("points"),
+        py::arg("face_vertex_counts"),
+        py::arg("face_vertex_indices"),
+        py::arg("uvs") = py::none(),
+        py::arg("uv_indices") = py::none(),
+        py::arg("triangulation") = "earclip",
+        py::arg("threads") = 1,
+        R"doc(
+Triangulate a USD-style polygon mesh in C++ (parallel over polygons).
+
+Parameters
+----------
+points : array_like, shape (N,3), float64 or float32
+face_vertex_counts : array_like, shape (P,), int
+    UsdGeomMesh faceVertexCounts. Polygons with fewer than 3 corners produce no triangles.
+face_vertex_indices : array_like, shape (K,), int
+    UsdGeomMesh faceVertexIndices, sum(face_vertex_counts) entries.
+uvs : Optional[array_like], shape (K,2), or (U,2) with uv_indices
+    Face-varying UVs, one per face vertex; turned into per-triangle UV triplets.
+uv_indices : Optional[array_like], shape (K,)
+    Indexed primvar: face vertex k uses uvs[uv_indices[k]]. For vertex-interpolated UVs
+    pass face_vertex_indices here.
+triangulation : str
+    "earclip" (default; correct for concave polygons) or "fan" (USD's own triangulation;
+    convex polygons only, slightly faster).
+threads : int
+    <=0 uses all hardware threads.
+
+Returns
+-------
+(verts (N,3) float64, faces (M,3) int32, face_uvs (M,6) float64 or None, face_ids (M,) int32)
+where face_ids[i] is the polygon triangle i was cut from. Raises ValueError on
+inconsistent counts or out-of-range indices.
+        )doc");
+
+    m.def(                                      // USD 多边形输入：三角化后直接简化
+        "simplify_polygons",
+        &simplify_polygons,
+        py::arg("points"),
+        py::arg("face_vertex_counts"),
+        py::arg("face_vertex_indices"),
+        py::arg("uvs") = py::none(),
+        py::arg("uv_indices") = py::none(),
+        py::arg("triangulation") = "earclip",
+        py::arg("ratio") = 0.5,
+        py::arg("target_faces") = -1,
+        py::arg("max_collapses") = -1,
+        py::arg("time_limit") = -1.0,
+        py::arg("progress_interval") = 20000,
+        py::arg("threads") = 1,
+        py::arg("collect_stats") = false,
+        py::arg("weld_eps") = -1.0,
+        py::arg("partitions") = 0,
+        py::arg("method") = "qem",
+        py::arg("keep_face_ids") = true,
+        py::arg("progress") = py::none(),
+        py::arg("precision") = "float64",
+        py::arg("max_error") = -1.0,
+        py::arg("max_error_relative") = false,
+        py::arg("placement") = "optimal",
+        py::arg("reorder") = false,
+        py::arg("boundary_weight") = 0.0,
+        py::arg("seam_weight") = 0.0,
+        py::arg("guard") = true,
+        py::arg("deterministic") = false,
+        R"doc(
+Triangulate a USD-style polygon mesh (as in triangulate_polygons) and simplify it, in
+one call with the GIL released. The ratio / target_faces refer to triangles.
+
+Parameters
+----------
+points, face_vertex_counts, face_vertex_indices, uvs, uv_indices, triangulation
+    As in triangulate_polygons.
+ratio, target_faces, max_collapses, time_limit, progress_interval, threads,
+collect_stats, weld_eps, partitions, method, progress
+    As in simplify_arrays.
+precision : str
+    As in simplify_arrays; "auto" looks at the dtype of points.
+max_error, max_error_relative, placement, reorder, boundary_weight, seam_weight, guard,
+deterministic
+    As in simplify_arrays.
+keep_face_ids : bool
+    Carry each triangle's source polygon through simplification and return it.
+
+Returns
+-------
+(new_verts, new_faces, new_face_uvs_or_None, face_ids_or_None), plus the report dict
+when collect_stats is True. face_ids[i] is the input polygon that surviving triangle i
+descends from, e.g. for carrying per-face primvars or GeomSubset membership over.
+        )doc");
+
+    m.def(                                      // 设置模块级结果缓存的字节上限（0 = 关闭并清空）
+        "set_cache_limit",
+        [](size_t max_bytes) { g_cache.set_limit(max_bytes); },
+        py::arg("max_bytes"),
+        R"doc(
+Bound the simplify_batch result cache to max_bytes of stored mesh data, evicting least
+recently used results. 0 (the default) disables the cache and drops its contents.
+        )doc");
+
+    m.def("clear_cache", [] { g_cache.clear(); }, "Drop every cached simplify_batch result.");
+    m.def("cache_info", &cache_info, "Dict with the result cache's entries, bytes, hits and misses.");
 }                                             // PYBIND11_MODULE 模块定义结束
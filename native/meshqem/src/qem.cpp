@@ -1,191 +1,579 @@
 // qem.cpp — Quadric Error Metrics simplification core (triangle-only).
 //
 // High-level flow:
-// 1) For each triangle, compute its plane equation and derive a 4x4 quadric K = p p^T.
+// 0) Optionally weld coincident vertices (opt.weld_eps, see weld.hpp).
+// 1) For each triangle, compute its plane equation and derive a 4x4 quadric K = p p^T
+//    (stored as the 10-coefficient upper triangle, see quadric.hpp).
 // 2) Accumulate K onto each incident vertex's quadric Q[v].
 // 3) Build vertex adjacency and initialize a min-heap of candidate edges with cost
-//    evaluated at the optimal position (solving a small linear system) or midpoint fallback.
-// 4) Repeatedly pop the cheapest edge and collapse v->u, updating vertex position, quadrics,
-//    adjacency, and affected faces; push updated neighbor edges back into the heap.
-// 5) Stop when target face count or time/collapse caps are reached; compact arrays.
+//    evaluated at the placement (opt.placement: optimal position from a small linear system,
+//    midpoint or endpoint), which is stored in the candidate.
+// 4) Repeatedly pop the cheapest edge and collapse v->u, moving u to the stored placement, merging quadrics,
+//    adjacency, and the faces incident to v (found through a vertex->face index);
+//    push updated neighbor edges back into the heap. Heap entries carry per-vertex version
+//    stamps, so entries made stale by a later collapse are discarded in O(1) at pop time.
+//    With opt.guard, a collapse that would flip a face or break the link condition is
+//    refused and its edge re-queued at a raised cost (collapse_ok).
+// 5) Stop when target face count, the error cap or time/collapse caps are reached; compact arrays
+//    (optionally in vertex-cache order, opt.reorder / reorder.hpp).
+//
+// Steps 1-3 (setup) are data-parallel over faces or vertices when opt.threads != 1; the
+// collapse loop itself is sequential. All scratch buffers live in a SimplifyWorkspace that
+// callers may keep across runs (workspace.hpp).
 //
 // Notes:
-// - This is a compact, dependency-free reference; it skips advanced guards such as flip detection,
-//   boundary preservation, attribute remapping, etc., to keep it readable and robust.
-// - Numerical robustness: we use double precision and drop degenerate faces early.
+// - This is a compact, dependency-free reference; the guard only looks at the incident-face rings
+//   of the two endpoints and attribute remapping is skipped, to keep it readable and robust.
+//   The guard does not see self-intersections between distant parts. Boundaries and face-varying UV seams
+//   can be held in place with penalty planes (opt.boundary_weight / opt.seam_weight); UV values
+//   themselves are carried with their faces, never re-interpolated.
+// - Numerical robustness: quadrics, costs and new positions are computed in double (also for
+//   MeshF, whose float positions are only the storage format) and degenerate faces are dropped
+//   early.
 
 #include "qem.hpp"
+#include "quadric.hpp"
+#include "topology.hpp"
+#include "workspace.hpp"
+#include "parallel.hpp"
+#include "weld.hpp"
+#include "progressive.hpp"
+#include "cluster.hpp"
+#include "reorder.hpp"
 #include <cmath>
 #include <chrono>
-#include <unordered_set>
-
-static inline void q_zero(Quadric& Q){ for(int i=0;i<16;++i) Q.m[i]=0; }
-static inline void q_add(Quadric& A,const Quadric& B){ for(int i=0;i<16;++i) A.m[i]+=B.m[i]; }
-static inline Quadric q_sum(const Quadric& A,const Quadric& B){ Quadric C; for(int i=0;i<16;++i) C.m[i]=A.m[i]+B.m[i]; return C; }
-
-// Build a quadric from plane parameters a,b,c,d (ax + by + cz + d = 0): K = p p^T.
-// Storing full 4x4 keeps code simple; for performance you could store symmetric upper triangle.
-static inline Quadric plane_quadric(double a,double b,double c,double d){
-    Quadric K; double p[4]={a,b,c,d};
-    int k=0; for(int r=0;r<4;++r) for(int c2=0;c2<4;++c2) K.m[k++]=p[r]*p[c2];
-    return K;
-}
+#include <algorithm>
+#include <climits>
+#include <type_traits>
 
 static inline Vec3 sub(const Vec3&a,const Vec3&b){ return {a.x-b.x,a.y-b.y,a.z-b.z}; }
 static inline Vec3 cross(const Vec3&a,const Vec3&b){ return {a.y*b.z-a.z*b.y, a.z*b.x-a.x*b.z, a.x*b.y-a.y*b.x}; }
 static inline double dot3(const Vec3&a,const Vec3&b){ return a.x*b.x+a.y*b.y+a.z*b.z; }
 static inline double len3(const Vec3&a){ return std::sqrt(dot3(a,a)); }
 
-// Solve a 3x3 linear system A x = b with partial pivoting; returns false if near-singular.
-// Used to find the point minimizing v'^T Q v' where Q is a merged quadric of an edge's endpoints.
-static bool solve3(const double A[9], const double b[3], double x[3]){
-    double M[3][4]={{A[0],A[1],A[2],b[0]},{A[3],A[4],A[5],b[1]},{A[6],A[7],A[8],b[2]}};
-    for(int i=0;i<3;++i){
-        // Pivot on the largest absolute value in the current column to improve stability.
-        int piv=i; double pv=std::abs(M[i][i]);
-        for(int r=i+1;r<3;++r){ double av=std::abs(M[r][i]); if(av>pv){piv=r; pv=av;} }
-        if(pv<1e-12) return false; // treat as singular; caller will fallback to midpoint
-        if(piv!=i) for(int c=0;c<4;++c) std::swap(M[i][c],M[piv][c]);
-        // Normalize the pivot row.
-        double div=M[i][i]; for(int c=0;c<4;++c) M[i][c]/=div;
-        // Eliminate rows below.
-        for(int r=i+1;r<3;++r){ double f=M[r][i]; for(int c=i;c<4;++c) M[r][c]-=f*M[i][c]; }
-    }
-    // Back substitution.
-    for(int i=2;i>=0;--i){ double s=M[i][3]; for(int c=i+1;c<3;++c) s-=M[i][c]*x[c]; x[i]=s; }
+static inline double clamp(double x,double lo,double hi){ return x<lo?lo:(x>hi?hi:x); }
+template <class T>
+static inline Vec3 to_d(const Vec3T<T>& p){ return {p.x,p.y,p.z}; }
+
+// Unit-normal plane (a,b,c,d) of face f; false for zero-area faces. Planes are recomputed
+// where needed instead of stored, which saves 32 bytes per face of scratch.
+template <class T>
+static inline bool face_plane(const MeshT<T>& mesh, const Tri& f, double pl[4]){
+    const Vec3 p = to_d(mesh.verts[f.a]);
+    const Vec3 q = to_d(mesh.verts[f.b]);
+    const Vec3 r = to_d(mesh.verts[f.c]);
+    // Compute geometric normal via cross product; drop zero-area faces for stability.
+    Vec3 n = cross({q.x-p.x,q.y-p.y,q.z-p.z}, {r.x-p.x,r.y-p.y,r.z-p.z});
+    double L = len3(n);
+    if(L<1e-12) return false;
+    n.x/=L; n.y/=L; n.z/=L;
+    pl[0]=n.x; pl[1]=n.y; pl[2]=n.z; pl[3]=-(n.x*p.x + n.y*p.y + n.z*p.z);
     return true;
 }
 
-// Evaluate the quadratic form v^T Q v at homogeneous coordinate v=[x,y,z,1].
-static inline double quadric_eval(const Quadric& Q, const double v[4]){
-    double Qv[4]={0,0,0,0}; int k=0;
-    for(int r=0;r<4;++r){
-        for(int c=0;c<4;++c){ Qv[r]+=Q.m[k++]*v[c]; }
-    }
-    return v[0]*Qv[0]+v[1]*Qv[1]+v[2]*Qv[2]+v[3]*Qv[3];
+// Phase stopwatch for SimplifyStats; does nothing (no clock reads) unless enabled.
+struct PhaseClock {
+    bool on; std::chrono::steady_clock::time_point t;
+    explicit PhaseClock(bool enabled): on(enabled) { if(on) t=std::chrono::steady_clock::now(); }
+    void lap(double& slot){ if(!on) return; auto n=std::chrono::steady_clock::now(); slot+=std::chrono::duration<double>(n-t).count(); t=n; }
+};
+
+template <class T>
+static size_t vec_bytes(const std::vector<T>& v){ return v.capacity()*sizeof(T); }
+
+size_t SimplifyWorkspace::capacity_bytes() const {
+    return vec_bytes(face_alive) + vec_bytes(v_alive) + vec_bytes(deg) + vec_bytes(mark) + vec_bytes(vq) + vec_bytes(ver)
+         + vec_bytes(off) + vec_bytes(heap) + vec_bytes(remap) + vec_bytes(v2) + vec_bytes(f2) + vec_bytes(uv2) + vec_bytes(id2)
+         + vec_bytes(v2f) + vec_bytes(uv2f) + vec_bytes(order) + tips.capacity_bytes() + vec_bytes(edges.slots)
+         + vec_bytes(vf.spans) + vf.peak*sizeof(int) + vec_bytes(adj.spans) + adj.peak*sizeof(int);
 }
 
-static inline double clamp(double x,double lo,double hi){ return x<lo?lo:(x>hi?hi:x); }
+static int resolve_target(int faces0, double ratio, int target_faces){
+    return target_faces>0? target_faces : (int)std::max(0.0, std::floor(faces0 * clamp(ratio,0.0,1.0)));
+}
+
+// Squared bounding-box diagonal of the vertices (0 for an empty or single-point mesh).
+template <class T>
+static double bbox_diag2(const MeshT<T>& mesh){
+    double lo[3] = {HUGE_VAL, HUGE_VAL, HUGE_VAL}, hi[3] = {-HUGE_VAL, -HUGE_VAL, -HUGE_VAL};
+    for(const auto& p: mesh.verts){ const double c[3]={p.x,p.y,p.z}; for(int k=0;k<3;++k){ lo[k]=std::min(lo[k],c[k]); hi[k]=std::max(hi[k],c[k]); } }
+    double d2=0; for(int k=0;k<3;++k) if(hi[k]>lo[k]) d2 += (hi[k]-lo[k])*(hi[k]-lo[k]);
+    return d2;
+}
+
+// opt.max_error in mesh units (relative values scaled by the bounding-box diagonal); <0 if unset.
+template <class T>
+static double resolve_max_error(const MeshT<T>& mesh, const SimplifyOptions& opt){
+    if(opt.max_error<0 || !opt.max_error_relative) return opt.max_error;
+    return opt.max_error*std::sqrt(bbox_diag2(mesh));
+}
+
+// Re-queue cost of an edge refused by opt.guard: max(cost, floor) * kRejectPenalty, with floor
+// kRejectFloor times the squared bounding-box diagonal. An entry whose raised cost would pass
+// kRejectDrop times that (or max_error) is dropped instead, so an edge is retried at most
+// ~30 times before one of its endpoints changes and it is pushed afresh.
+static const double kRejectPenalty = 4.0, kRejectFloor = 1e-12, kRejectDrop = 1e6;
 
-bool qem_simplify(Mesh& mesh, const SimplifyOptions& opt, SimplifyReport& rep){
+namespace {
+
+// Compaction outputs of the workspace matching the mesh's precision.
+std::vector<Vec3>& ws_verts(SimplifyWorkspace& ws, const Mesh&){ return ws.v2; }
+std::vector<Vec3f>& ws_verts(SimplifyWorkspace& ws, const MeshF&){ return ws.v2f; }
+std::vector<std::array<double,6>>& ws_uvs(SimplifyWorkspace& ws, const Mesh&){ return ws.uv2; }
+std::vector<std::array<float,6>>& ws_uvs(SimplifyWorkspace& ws, const MeshF&){ return ws.uv2f; }
+
+// One simplification run over `mesh`, split into phases so a caller can stop at several
+// targets (LOD chains) without repeating the setup:
+//   setup()            weld, quadrics, incidence/adjacency, initial heap (steps 0-3)
+//   collapse_until(t)  run the collapse loop until at most t faces remain (step 4)
+//   snapshot(out)      write the current compacted mesh into `out`, state untouched
+//   finish()           compact `mesh` in place and fill the report (step 5)
+// All scratch lives in the workspace; `mesh` is modified in place as collapses happen.
+// T is the position storage (Mesh or MeshF); the recorded `pm` log exists for Mesh only.
+template <class T>
+class Simplifier {
+public:
+    Simplifier(MeshT<T>& mesh, const SimplifyOptions& opt, SimplifyReport& rep, SimplifyWorkspace* wsp, ProgressiveMesh* pm = nullptr)
+        : mesh(mesh), opt(opt), rep(rep), ws(wsp? *wsp : local), reused(wsp!=nullptr), pm(pm), clk(opt.collect_stats) {}
+
+    // Vertices flagged in `mask` (indexed like mesh.verts) are never collapsed or moved.
+    // Call before setup(); the mask must outlive the Simplifier.
+    void lock(const char* mask){ locked = mask; }
+    // Returns false when there is nothing to simplify (no faces); finish() still applies.
+    bool setup();
+    void collapse_until(int target, int max_collapses);
+    void snapshot(MeshT<T>& out);
+    void finish();
+    int faces_now() const { return faces_cur; }
+
+private:
+    EdgeCand make_cand(int u, int v, size_t& fallbacks_out);
+    bool collapse_ok(const EdgeCand& e);
+    void add_constraint_planes();
+    bool movable(int u, int v) const { return !locked || (!locked[u] && !locked[v]); }
+    void sweep_stale();
+    // Cancel flag, progress hook and time limit; false when the loop must stop.
+    bool poll();
+    void report_progress(int target);
+    // Compact live vertices/faces (and aligned UVs) into the given buffers.
+    void compact_into(std::vector<Vec3T<T>>& v2, std::vector<Tri>& f2, std::vector<std::array<T,6>>& uv2, std::vector<int>& id2,
+                      bool& has_uv, bool& has_id);
+
+    MeshT<T>& mesh;
+    const SimplifyOptions& opt;
+    SimplifyReport& rep;
+    SimplifyWorkspace local;          // used when the caller passes no workspace
+    SimplifyWorkspace& ws;
+    const bool reused;
+    ProgressiveMesh* pm;              // optional collapse log
+    const char* locked = nullptr;     // optional per-vertex lock mask
+    PhaseClock clk;
+    std::chrono::steady_clock::time_point t0;  // start of the collapse phase (time_limit)
+    int faces_cur = 0, collapsed = 0, stamp = 0, next_progress = 0;
+    double err_cap = HUGE_VAL, err_max = 0;  // cost limit from opt.max_error; largest cost applied
+    double reject_floor = 0, reject_drop = 0; // opt.guard re-queue costs (kRejectFloor / kRejectDrop)
+    size_t edges_cur = 0, peak_heap = 0, pushes = 0, fallbacks = 0, stale = 0, flip_rej = 0, link_rej = 0;
+    bool stopped = false;             // time limit or cancel: later collapse_until calls do nothing
+};
+
+template <class T>
+bool Simplifier<T>::setup(){
     rep.faces_before = mesh.faces.size();
     rep.verts_before = mesh.verts.size();
-    if(mesh.faces.empty()) { rep.faces_after=0; rep.verts_after=mesh.verts.size(); return true; }
-
-    // target faces
-    int faces0 = (int)mesh.faces.size();
-    int target = opt.target_faces>0? opt.target_faces : (int)std::max(0.0, std::floor(faces0 * clamp(opt.ratio,0.0,1.0)));
-    int max_collapses = opt.max_collapses>0? opt.max_collapses : (faces0 - target);
-    if(max_collapses<0) max_collapses=0;
-
-    // build per-vertex quadrics
-    std::vector<Quadric> vq(mesh.verts.size());
-    for(auto& Q: vq) q_zero(Q);
-    std::vector<char> face_alive(mesh.faces.size(), 1);
-    for(size_t fi=0; fi<mesh.faces.size(); ++fi){
-        auto& f = mesh.faces[fi];
-        auto& p = mesh.verts[f.a];
-        auto& q = mesh.verts[f.b];
-        auto& r = mesh.verts[f.c];
-        // Compute geometric normal via cross product; drop zero-area faces for stability.
-        Vec3 n = cross({q.x-p.x,q.y-p.y,q.z-p.z}, {r.x-p.x,r.y-p.y,r.z-p.z});
-        double L = len3(n);
-        if(L<1e-12){ face_alive[fi]=0; continue; }
-        n.x/=L; n.y/=L; n.z/=L; double d = - (n.x*p.x + n.y*p.y + n.z*p.z);
-        Quadric K = plane_quadric(n.x,n.y,n.z,d);
-        q_add(vq[f.a], K); q_add(vq[f.b], K); q_add(vq[f.c], K);
-    }
-
-    // adjacency
-    std::vector<std::unordered_set<int>> adj(mesh.verts.size());
-    for(auto& f: mesh.faces){
-        adj[f.a].insert(f.b); adj[f.a].insert(f.c);
-        adj[f.b].insert(f.a); adj[f.b].insert(f.c);
-        adj[f.c].insert(f.a); adj[f.c].insert(f.b);
-    }
-
-    // heap init
-    std::priority_queue<EdgeCand> heap;
-    auto push_edge = [&](int u,int v){
-        // Canonicalize ordering so each undirected edge is pushed once (u<v).
-        if(u==v) return; if(u>v) std::swap(u,v); if(!adj[u].count(v)) return; 
-        // Combine vertex quadrics and estimate the best collapse position.
-        Quadric Quv = q_sum(vq[u], vq[v]);
-        // Extract 3x3 (upper-left) and 3x1 (-Q[0:3,3]) to solve for [x,y,z].
-        double A[9]={Quv.m[0],Quv.m[1],Quv.m[2], Quv.m[4],Quv.m[5],Quv.m[6], Quv.m[8],Quv.m[9],Quv.m[10]};
-        double B[3]={-Quv.m[3], -Quv.m[7], -Quv.m[11]};
-        double x[3]; bool ok = solve3(A,B,x);
-        if(!ok){ // fallback midpoint for robustness when A is singular (common near boundaries)
-            x[0]=(mesh.verts[u].x+mesh.verts[v].x)*0.5;
-            x[1]=(mesh.verts[u].y+mesh.verts[v].y)*0.5;
-            x[2]=(mesh.verts[u].z+mesh.verts[v].z)*0.5;
+    rep.scratch_bytes = 0;
+    rep.final_error = 0;
+    rep.stats = SimplifyStats{};
+    SimplifyStats& st = rep.stats;
+    // Optional weld: merging soup vertices first gives QEM shared edges to collapse.
+    if(opt.weld_eps>=0){ st.welded_verts = weld_vertices(mesh, opt.weld_eps, opt.threads); clk.lap(st.t_weld); }
+    faces_cur = (int)mesh.faces.size();
+    if(mesh.faces.empty()) return false;
+    const double max_error = resolve_max_error(mesh, opt);
+    if(max_error>=0) err_cap = max_error*max_error;
+    if(opt.guard){ const double d2 = bbox_diag2(mesh); reject_floor = kRejectFloor*d2; reject_drop = kRejectDrop*d2; }
+
+    const int threads = resolve_threads(opt.threads);
+    const size_t nv = mesh.verts.size(), nf = mesh.faces.size();
+
+    // Zero-area faces are dropped up front for stability (face-parallel).
+    std::vector<char>& face_alive = ws.face_alive;
+    face_alive.assign(nf, 1);
+    parallel_for(nf, threads, [&](size_t b, size_t e, int){
+        double pl[4];
+        for(size_t fi=b; fi<e; ++fi) if(!face_plane(mesh, mesh.faces[fi], pl)) face_alive[fi]=0;
+    });
+    st.degenerate_faces = (size_t)std::count(face_alive.begin(), face_alive.end(), 0);
+    clk.lap(st.t_quadrics);
+    if constexpr (std::is_same<T,double>::value) if(pm){
+        // Base of the log: the mesh being collapsed, minus the zero-area faces dropped above.
+        const bool has_uv = mesh.face_uvs.size() == nf, has_id = mesh.face_ids.size() == nf;
+        pm->log.clear();
+        pm->base.verts = mesh.verts; pm->base.faces.clear(); pm->base.face_uvs.clear(); pm->base.face_ids.clear();
+        for(size_t fi=0; fi<nf; ++fi) if(face_alive[fi]){
+            pm->base.faces.push_back(mesh.faces[fi]);
+            if(has_uv) pm->base.face_uvs.push_back(mesh.face_uvs[fi]);
+            if(has_id) pm->base.face_ids.push_back(mesh.face_ids[fi]);
         }
-        double v4[4]={x[0],x[1],x[2],1.0};
-        double cost = quadric_eval(Quv, v4);
-        heap.push({u,v,cost});
-    };
+    }
 
-    for(size_t u=0; u<adj.size(); ++u){ for(int v: adj[u]) if((int)u<v) push_edge((int)u,v); }
+    // vertex -> incident faces, packed CSR-style; kept up to date during collapses so
+    // each collapse only touches the faces around v. Built over all faces first so the
+    // neighbor lists below also see edges of the zero-area faces dropped above.
+    // The scatter stays serial: it is a cheap O(F) pass and keeps every list in face order.
+    VertexLists& vf = ws.vf;
+    std::vector<int>& deg = ws.deg;
+    {
+        deg.assign(nv, 0);
+        for(auto& f: mesh.faces){ deg[f.a]++; deg[f.b]++; deg[f.c]++; }
+        vf.reset(deg);
+        for(size_t fi=0; fi<nf; ++fi){ auto& f=mesh.faces[fi];
+            vf.push(f.a,(int)fi); vf.push(f.b,(int)fi); vf.push(f.c,(int)fi); }
+    }
 
-    auto t0 = std::chrono::steady_clock::now();
-    int collapsed=0;
-    int faces_cur = faces0;
-    int next_progress = opt.progress_interval>0? opt.progress_interval: 20000;
+    // adjacency: vertex -> neighbor vertices in the same flat pool layout. Replaces one
+    // hash set per vertex; lists are short (valence) so linear scans stay in cache.
+    // Vertex-parallel: each vertex's sorted neighbor set is gathered from its faces, once to
+    // size the slots and once to fill them (every vertex writes only its own slot).
+    VertexLists& adj = ws.adj;
+    {
+        auto gather = [&](int u, std::vector<int>& nb){
+            nb.clear();
+            for(const int* it=vf.begin(u); it!=vf.end(u); ++it){ auto& f=mesh.faces[*it];
+                if(f.a!=u) nb.push_back(f.a); if(f.b!=u) nb.push_back(f.b); if(f.c!=u) nb.push_back(f.c); }
+            std::sort(nb.begin(), nb.end()); nb.erase(std::unique(nb.begin(), nb.end()), nb.end());
+        };
+        deg.assign(nv, 0);
+        parallel_for(nv, threads, [&](size_t b, size_t e, int){
+            std::vector<int> nb; for(size_t u=b; u<e; ++u){ gather((int)u, nb); deg[u]=(int)nb.size(); } });
+        adj.reset(deg);
+        parallel_for(nv, threads, [&](size_t b, size_t e, int){
+            std::vector<int> nb; for(size_t u=b; u<e; ++u){ gather((int)u, nb); for(int w: nb) adj.push((int)u, w); } });
+    }
+    clk.lap(st.t_adjacency);
+    // `mark` is a per-vertex stamp used to dedupe while merging lists during collapses.
+    ws.mark.assign(nv, -1);
+    stamp = 0;
+
+    // Faces dropped as degenerate above leave every vertex's face list; then each vertex
+    // gathers its quadric from its own faces (race-free, and summed in face order exactly
+    // like a serial scatter, so the result is the same for any thread count).
+    std::vector<Quadric>& vq = ws.vq;
+    vq.resize(nv);
+    parallel_for(nv, threads, [&](size_t b, size_t e, int){
+        double p[4];
+        for(size_t u=b; u<e; ++u){
+            int* fu=vf.begin((int)u); int n=0; for(int i=0;i<vf.size((int)u);++i){ if(face_alive[fu[i]]) fu[n++]=fu[i]; } vf.truncate((int)u,n);
+            Quadric& Q = vq[u]; q_zero(Q);
+            for(int i=0;i<n;++i){ face_plane(mesh, mesh.faces[fu[i]], p); q_add(Q, plane_quadric(p[0],p[1],p[2],p[3])); }
+        }
+    });
+    add_constraint_planes();
+    clk.lap(st.t_quadrics);
+
+    // heap init: a binary min-heap over a plain vector (std heap algorithms) so stale
+    // entries can be swept out in bulk. ver[x] is bumped whenever x's quadric/position
+    // changes or x dies; an entry is live only while both stamps still match.
+    std::vector<EdgeCand>& heap = ws.heap;
+    heap.clear();
+    ws.ver.assign(nv, 0);
+
+    // Initial candidates: each vertex owns the edges (u<w) in its list; a prefix sum over
+    // those counts gives every vertex a fixed output slot, so enumeration and cost
+    // evaluation run vertex-parallel straight into the heap array, then a level-parallel
+    // heapify restores the heap property.
+    {
+        std::vector<size_t>& off = ws.off;
+        off.assign(nv+1, 0);
+        size_t ends=0;
+        for(size_t u=0; u<nv; ++u){ size_t k=0; for(const int* it=adj.begin((int)u); it!=adj.end((int)u); ++it) k += (int)u<*it && movable((int)u,*it); off[u+1]=off[u]+k; ends += (size_t)adj.size((int)u); }
+        edges_cur = ends/2;  // every edge, including locked ones that never enter the heap
+        heap.resize(off[nv]);
+        std::vector<size_t> fb((size_t)parallel_chunks(nv, threads), 0);
+        parallel_for(nv, threads, [&](size_t b, size_t e, int c){
+            for(size_t u=b; u<e; ++u){ size_t k=off[u]; for(const int* it=adj.begin((int)u); it!=adj.end((int)u); ++it) if((int)u<*it && movable((int)u,*it)) heap[k++]=make_cand((int)u,*it,fb[c]); }
+        });
+        for(size_t x: fb) fallbacks += x;
+        pushes = heap.size();
+        parallel_make_heap(heap, threads);
+        // Setup-only buffers: a one-shot workspace gives them back before the collapse loop
+        // so they do not add to the peak; a reused one keeps them for the next run.
+        if(!reused){ std::vector<size_t>().swap(off); std::vector<int>().swap(deg); }
+    }
+    // edges_cur (set above) is the current number of undirected edges. A collapse never
+    // adds edges, so the live entries in the heap never exceed this count.
+    peak_heap = heap.size();
+    clk.lap(st.t_heap_init);
 
     // alive flags
-    std::vector<char> v_alive(mesh.verts.size(), 1);
+    ws.v_alive.assign(nv, 1);
+    next_progress = opt.progress_interval>0? opt.progress_interval: 20000;
+    t0 = std::chrono::steady_clock::now();
+    return true;
+}
+
+// Boundary and UV-seam constraints: every surviving face's edges go into a hash table (one
+// linear pass); an edge with a single face is a boundary edge, one whose two faces disagree
+// on the UVs of either endpoint is a seam edge. Each such edge gets the plane through it
+// perpendicular to its face(s), weighted relative to one face plane and added to both
+// endpoints' quadrics, so collapses slide boundary and seam vertices along the line instead of
+// pulling them off it. Edges with three or more faces get none.
+template <class T>
+void Simplifier<T>::add_constraint_planes(){
+    const bool has_uv = opt.seam_weight>0 && mesh.face_uvs.size()==mesh.faces.size();
+    if(!(opt.boundary_weight>0) && !has_uv) return;
+    const size_t nv = mesh.verts.size(), nf = mesh.faces.size();
+    const std::vector<char>& face_alive = ws.face_alive;
+    EdgeTable& et = ws.edges;
+    size_t ends = 0;
+    for(size_t u=0; u<nv; ++u) ends += (size_t)ws.adj.size((int)u);
+    et.reset(ends/2);
+    for(size_t fi=0; fi<nf; ++fi) if(face_alive[fi]){
+        const Tri& f = mesh.faces[fi];
+        et.add(f.a, f.b, (int)fi); et.add(f.b, f.c, (int)fi); et.add(f.c, f.a, (int)fi);
+    }
+    auto corner = [&](int fi, int x){ const Tri& f = mesh.faces[fi]; return f.a==x? 0 : f.b==x? 1 : 2; };
+    auto same_uv = [&](int f0, int f1, int x){
+        const int i = corner(f0, x), j = corner(f1, x);
+        return mesh.face_uvs[f0][2*i]==mesh.face_uvs[f1][2*j] && mesh.face_uvs[f0][2*i+1]==mesh.face_uvs[f1][2*j+1];
+    };
+    auto add_plane = [&](int fi, int u, int v, double w){
+        double pl[4]; face_plane(mesh, mesh.faces[fi], pl);
+        const Vec3 pu = to_d(mesh.verts[u]);
+        Vec3 m = cross(sub(to_d(mesh.verts[v]), pu), {pl[0], pl[1], pl[2]});
+        const double L = len3(m);
+        if(L<1e-12) return;
+        const double s = std::sqrt(w)/L;
+        const Quadric K = plane_quadric(m.x*s, m.y*s, m.z*s, -dot3(m, pu)*s);
+        q_add(ws.vq[u], K); q_add(ws.vq[v], K);
+    };
+    SimplifyStats& st = rep.stats;
+    for(const EdgeTable::Slot& s: et.slots){
+        if(s.key==EdgeTable::kEmpty) continue;
+        const int u = EdgeTable::key_u(s.key), v = EdgeTable::key_v(s.key);
+        if(s.f1==-1){
+            if(opt.boundary_weight>0){ add_plane(s.f0, u, v, opt.boundary_weight); st.boundary_edges++; }
+        } else if(s.f1>=0 && has_uv && !(same_uv(s.f0, s.f1, u) && same_uv(s.f0, s.f1, v))){
+            add_plane(s.f0, u, v, opt.seam_weight); add_plane(s.f1, u, v, opt.seam_weight); st.seam_edges++;
+        }
+    }
+    if(!reused) std::vector<EdgeTable::Slot>().swap(et.slots);  // setup-only, like `off`
+}
+
+// Build the candidate for edge (u,v): placement per opt.placement and the cost there.
+// `fallbacks_out` counts singular systems (per caller, so parallel callers do not share it).
+template <class T>
+EdgeCand Simplifier<T>::make_cand(int u, int v, size_t& fallbacks_out){
+    // Canonicalize ordering so each undirected edge is pushed once (u<v).
+    if(u>v) std::swap(u,v);
+    // Combine vertex quadrics and estimate the best collapse position.
+    Quadric Quv = q_sum(ws.vq[u], ws.vq[v]);
+    EdgeCand e{u,v,ws.ver[u],ws.ver[v],HUGE_VAL,0,0,0};
+    if(opt.placement==Placement::Optimal){
+        // Extract 3x3 (upper-left) and 3x1 (-Q[0:3,3]) to solve for [x,y,z].
+        double A[9], B[3]; quadric_system(Quv, A, B);
+        double x[4]; x[3]=1.0;
+        if(solve3(A,B,x)){ e.cost=quadric_eval(Quv, x); e.x=x[0]; e.y=x[1]; e.z=x[2]; return e; }
+        fallbacks_out++;  // singular (common in flat regions and near boundaries): best of the three below
+    }
+    const Vec3 pu = to_d(mesh.verts[u]), pv = to_d(mesh.verts[v]);
+    auto take = [&](double x, double y, double z){
+        const double p[4]={x,y,z,1.0}; const double c=quadric_eval(Quv, p);
+        if(c<e.cost){ e.cost=c; e.x=x; e.y=y; e.z=z; }
+    };
+    if(opt.placement!=Placement::Endpoint) take((pu.x+pv.x)*0.5, (pu.y+pv.y)*0.5, (pu.z+pv.z)*0.5);
+    if(opt.placement!=Placement::Midpoint){ take(pu.x, pu.y, pu.z); take(pv.x, pv.y, pv.z); }
+    if(e.cost==HUGE_VAL){ e.x=pu.x; e.y=pu.y; e.z=pu.z; }  // non-finite costs: keep u, sort last
+    return e;
+}
+
+// opt.guard: whether collapsing e (v into u, u moved to the placement) keeps the mesh sane,
+// judged from the incident-face rings of u and v only, so O(valence):
+// - link condition: every vertex adjacent to both u and v must be the apex of a face on edge
+//   uv; any other common neighbour w would leave edge (u,w) with three or more faces;
+// - no flip: every face around u or v that survives the collapse keeps its orientation (its
+//   normal turns by less than 90 degrees) and keeps a nonzero area.
+// Bumps the matching reject counter on refusal.
+template <class T>
+bool Simplifier<T>::collapse_ok(const EdgeCand& e){
+    const int u=e.u, v=e.v;
+    const std::vector<char>& face_alive = ws.face_alive;
+    const VertexLists& vf = ws.vf;
+    std::vector<int>& mark = ws.mark;
+    const int ring = ++stamp, seen = ++stamp;
+    int common = 0, on_edge = 0;
+    for(const int* it=vf.begin(u); it!=vf.end(u); ++it){ if(!face_alive[*it]) continue; const Tri& f=mesh.faces[*it];
+        mark[f.a]=ring; mark[f.b]=ring; mark[f.c]=ring; }
+    for(const int* it=vf.begin(v); it!=vf.end(v); ++it){ if(!face_alive[*it]) continue; const Tri& f=mesh.faces[*it];
+        on_edge += f.a==u || f.b==u || f.c==u;
+        for(int w: {f.a,f.b,f.c}) if(w!=u && w!=v && mark[w]==ring){ mark[w]=seen; common++; } }
+    if(common>on_edge){ link_rej++; return false; }
 
-    while(faces_cur>target && !heap.empty() && collapsed<max_collapses){
-        // time limit
-        if(opt.time_limit>0){
-            auto dt = std::chrono::duration<double>(std::chrono::steady_clock::now()-t0).count();
-            if(dt >= opt.time_limit) break;
+    const Vec3 p{e.x, e.y, e.z};
+    auto flips = [&](int x, int other){
+        for(const int* it=vf.begin(x); it!=vf.end(x); ++it){ if(!face_alive[*it]) continue; const Tri& f=mesh.faces[*it];
+            if(f.a==other || f.b==other || f.c==other) continue;  // degenerates and dies with the collapse
+            const Vec3 a=to_d(mesh.verts[f.a]), b=to_d(mesh.verts[f.b]), c=to_d(mesh.verts[f.c]);
+            const Vec3 n0 = cross(sub(b,a), sub(c,a));
+            const Vec3 A = f.a==x? p : a, B = f.b==x? p : b, C = f.c==x? p : c;
+            const Vec3 n1 = cross(sub(B,A), sub(C,A));
+            if(dot3(n0,n1)<=0 && dot3(n0,n0)>0) return true;  // faces already degenerate have no orientation to keep
         }
+        return false;
+    };
+    if(flips(u, v) || flips(v, u)){ flip_rej++; return false; }
+    return true;
+}
 
-        auto e = heap.top(); heap.pop();
-        int u=e.u, v=e.v; if(!v_alive[u] || !v_alive[v]) continue; if(!adj[u].count(v)) continue;
+template <class T>
+bool Simplifier<T>::poll(){
+    if(opt.cancel && opt.cancel->load(std::memory_order_relaxed)){ rep.stats.cancelled = stopped = true; return false; }
+    if(opt.time_limit>0){
+        auto dt = std::chrono::duration<double>(std::chrono::steady_clock::now()-t0).count();
+        if(dt >= opt.time_limit){ rep.stats.time_limited = stopped = true; return false; }
+    }
+    return true;
+}
+
+template <class T>
+void Simplifier<T>::report_progress(int target){
+    next_progress += opt.progress_interval>0? opt.progress_interval: 20000;
+    if(!opt.progress){
+        // emit a single-line progress to stderr (Python side collects if needed)
+        fprintf(stderr, "[cpp] collapsed=%d faces_now=%d target=%d\n", collapsed, faces_cur, target);
+        return;
+    }
+    SimplifyProgress p;
+    p.collapses = collapsed; p.faces = faces_cur; p.target = target;
+    p.elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now()-t0).count();
+    if(!opt.progress(p)) rep.stats.cancelled = stopped = true;
+}
+
+// Once stale entries make up more than half of the heap, sweep them out and re-heapify.
+// The sweep is O(heap) and runs at most once per edges_cur pushes, so it is amortized O(1).
+template <class T>
+void Simplifier<T>::sweep_stale(){
+    std::vector<EdgeCand>& heap = ws.heap; const std::vector<int>& ver = ws.ver;
+    size_t n=0;
+    for(size_t i=0;i<heap.size();++i){ const auto& e=heap[i]; if(ver[e.u]==e.ver_u && ver[e.v]==e.ver_v) heap[n++]=e; }
+    heap.resize(n);
+    std::make_heap(heap.begin(), heap.end());
+}
 
-        // new position: midpoint (simple, robust). For quality, you could also set to x[] above
-        // and re-evaluate local costs; we keep midpoint to avoid repeated re-solves.
-        double nx=(mesh.verts[u].x+mesh.verts[v].x)*0.5;
-        double ny=(mesh.verts[u].y+mesh.verts[v].y)*0.5;
-        double nz=(mesh.verts[u].z+mesh.verts[v].z)*0.5;
-        mesh.verts[u].x=nx; mesh.verts[u].y=ny; mesh.verts[u].z=nz;
+template <class T>
+void Simplifier<T>::collapse_until(int target, int max_collapses){
+    std::vector<EdgeCand>& heap = ws.heap;
+    std::vector<int>& ver = ws.ver;
+    std::vector<int>& mark = ws.mark;
+    std::vector<char>& face_alive = ws.face_alive;
+    std::vector<char>& v_alive = ws.v_alive;
+    std::vector<Quadric>& vq = ws.vq;
+    VertexLists& vf = ws.vf;
+    VertexLists& adj = ws.adj;
+    auto push_edge = [&](int u,int v){ heap.push_back(make_cand(u,v,fallbacks)); std::push_heap(heap.begin(), heap.end()); pushes++; };
+
+    int until_poll = 0;
+    while(!stopped && faces_cur>target && !heap.empty() && collapsed<max_collapses){
+        // cancel flag and time limit, every kPollCollapses iterations (stale pops included)
+        if(--until_poll<=0){ until_poll = kPollCollapses; if(!poll()) break; }
+
+        std::pop_heap(heap.begin(), heap.end()); auto e = heap.back(); heap.pop_back();
+        int u=e.u, v=e.v; if(ver[u]!=e.ver_u || ver[v]!=e.ver_v){ stale++; continue; } // stale: an endpoint changed since push
+        // every live candidate costs at least this much: put it back so a later call stops here too
+        if(e.cost>err_cap){ heap.push_back(e); std::push_heap(heap.begin(), heap.end()); rep.stats.error_limited = true; break; }
+        // refused by the guard: back into the heap at a raised cost, so the loop moves on to
+        // other edges and retries this one later (after its neighbourhood may have changed)
+        if(opt.guard){
+            if(!collapse_ok(e)){
+                const double c = std::max(e.cost, reject_floor)*kRejectPenalty;
+                if(c>e.cost && c<=reject_drop && c<=err_cap){ e.cost=c; heap.push_back(e); std::push_heap(heap.begin(), heap.end()); pushes++; }
+                continue;
+            }
+            // a re-queued entry carries its raised cost; the error reached is the true one
+            const double x[4]={e.x, e.y, e.z, 1.0}; e.cost = quadric_eval(q_sum(vq[u], vq[v]), x);
+        }
+        if(e.cost>err_max) err_max = e.cost;
+
+        // new position: the placement the entry's cost was evaluated at
+        const double nx=e.x, ny=e.y, nz=e.z;
+        mesh.verts[u].x=(T)nx; mesh.verts[u].y=(T)ny; mesh.verts[u].z=(T)nz;
 
         // merge quadrics
         q_add(vq[u], vq[v]);
 
-        // rewire adjacency: move neighbors of v to u
-        for(int w: adj[v]){ if(w==u) continue; adj[w].erase(v); adj[w].insert(u); adj[u].insert(w); }
-        adj[v].clear(); v_alive[v]=0;
+        // rewire adjacency: move neighbors of v to u. Lists are symmetric, so a w not yet
+        // adjacent to u gets v renamed to u; a shared neighbor just forgets v.
+        ++stamp; for(const int* it=adj.begin(u); it!=adj.end(u); ++it) mark[*it]=stamp;
+        for(int i=0; i<adj.size(v); ++i){ int w=adj.begin(v)[i]; if(w==u) continue;
+            int* lw=adj.begin(w); int n=adj.size(w);
+            if(mark[w]!=stamp){ mark[w]=stamp; for(int k=0;k<n;++k) if(lw[k]==v){ lw[k]=u; break; } adj.push(u,w); }
+            else { for(int k=0;k<n;++k) if(lw[k]==v){ lw[k]=lw[n-1]; adj.truncate(w,n-1); break; } edges_cur--; }
+        }
+        { int* lu=adj.begin(u); int n=adj.size(u); for(int k=0;k<n;++k) if(lu[k]==v){ lu[k]=lu[n-1]; adj.truncate(u,n-1); break; } edges_cur--; }
+        adj.release(v); v_alive[v]=0;
+        ver[u]++; ver[v]++; // invalidate every queued entry touching u or v
 
-        // update faces: replace v with u, drop degenerate
-        for(size_t fi=0; fi<mesh.faces.size(); ++fi){ if(!face_alive[fi]) continue; auto& f=mesh.faces[fi];
-            int a=f.a, b=f.b, c=f.c; if(a==v) a=u; if(b==v) b=u; if(c==v) c=u; 
+        // update faces around v: replace v with u, drop degenerate; survivors join u's list
+        // (indexed access: pushing onto u may relocate the pool, but never reorders v's list)
+        for(int i=0; i<vf.size(v); ++i){ int fi=vf.begin(v)[i]; if(!face_alive[fi]) continue; auto& f=mesh.faces[fi];
+            int a=f.a, b=f.b, c=f.c; if(a==v) a=u; if(b==v) b=u; if(c==v) c=u;
             if(a==b || b==c || a==c){ face_alive[fi]=0; faces_cur--; continue; }
-            f.a=a; f.b=b; f.c=c; }
+            f.a=a; f.b=b; f.c=c; vf.push(u, fi); }
+        vf.release(v);
+        // drop faces that just died from u's list (filtered in place)
+        { int* fu=vf.begin(u); int n=0; for(int i=0;i<vf.size(u);++i){ if(face_alive[fu[i]]) fu[n++]=fu[i]; } vf.truncate(u,n); }
+
+        if(pm) pm->log.push_back({nx, ny, nz, v, u, faces_cur - (int)rep.stats.degenerate_faces, 0});
 
         // refresh candidate edges around u
-        for(int w: adj[u]){ int a=u,b=w; if(a>b) std::swap(a,b); push_edge(a,b); }
+        for(int i=0; i<adj.size(u); ++i){ int w=adj.begin(u)[i]; if(movable(u,w)) push_edge(u, w); }
+        if(heap.size() > peak_heap) peak_heap = heap.size();
+        if(heap.size() > 2*edges_cur + 1024) sweep_stale();
 
-        if(++collapsed >= next_progress){
-            // emit a single-line progress to stderr (Python side collects if needed)
-            fprintf(stderr, "[cpp] collapsed=%d faces_now=%d target=%d\n", collapsed, faces_cur, target);
-            next_progress += opt.progress_interval>0? opt.progress_interval: 20000;
-        }
+        if(++collapsed >= next_progress) report_progress(target);
     }
+    SimplifyStats& st = rep.stats;
+    st.collapses = (size_t)collapsed;
+    st.heap_pushes = pushes; st.solve_fallbacks = fallbacks; st.stale_pops = stale; st.peak_heap = peak_heap;
+    st.flip_rejects = flip_rej; st.link_rejects = link_rej;
+    rep.final_error = std::sqrt(err_max);
+    clk.lap(st.t_collapse);
+}
 
-    // compact vertices and faces  remove dead vertices and reindex faces.
-    std::vector<int> remap(mesh.verts.size(), -1); remap.reserve(mesh.verts.size());
-    std::vector<Vec3> v2; v2.reserve(mesh.verts.size());
-    for(size_t i=0;i<mesh.verts.size();++i){ if(v_alive[i]){ remap[i]=(int)v2.size(); v2.push_back(mesh.verts[i]); } }
+template <class T>
+void Simplifier<T>::compact_into(std::vector<Vec3T<T>>& v2, std::vector<Tri>& f2, std::vector<std::array<T,6>>& uv2, std::vector<int>& id2,
+                                 bool& has_uv, bool& has_id){
+    const std::vector<char>& face_alive = ws.face_alive;
+    const std::vector<char>& v_alive = ws.v_alive;
+    // compact vertices and faces  remove dead vertices and reindex faces.
+    std::vector<int>& remap = ws.remap; remap.assign(mesh.verts.size(), -1);
+    v2.clear(); v2.reserve(mesh.verts.size());
+    if(!opt.reorder) for(size_t i=0;i<mesh.verts.size();++i){ if(v_alive[i]){ remap[i]=(int)v2.size(); v2.push_back(mesh.verts[i]); } }
 
-    std::vector<Tri> f2; f2.reserve(mesh.faces.size());
+    f2.clear(); f2.reserve((size_t)faces_cur);
     // 若存在与 faces 对齐的 face_uvs，则在压缩 faces 时同步压缩 UV triplets；
     // 仅携带/过滤，不在 C++ 端修改具体 UV 值。
-    std::vector<std::array<double, 6>> uv2;
-    bool has_uv = (mesh.face_uvs.size() == mesh.faces.size());
-    if(has_uv) uv2.reserve(mesh.face_uvs.size());
+    uv2.clear();
+    has_uv = (mesh.face_uvs.size() == mesh.faces.size());
+    if(has_uv) uv2.reserve((size_t)faces_cur);
+    id2.clear();
+    has_id = (mesh.face_ids.size() == mesh.faces.size());
+    if(has_id) id2.reserve((size_t)faces_cur);
+
+    if(opt.reorder){
+        // Tipsify over the collapse loop's vertex->face index; vertices get numbered on first
+        // use by the emitted faces, so unreferenced vertices drop out (reorder.hpp).
+        const VertexLists& vf = ws.vf;
+        tipsify_order(mesh.faces.data(), mesh.faces.size(), mesh.verts.size(),
+                      [&](int v){ return std::make_pair(vf.begin(v), vf.end(v)); }, face_alive.data(), kReorderCacheSize, ws.tips, ws.order);
+        for(int fi: ws.order){
+            const Tri& f = mesh.faces[fi];
+            for(int x: {f.a,f.b,f.c}) if(remap[x]<0){ remap[x]=(int)v2.size(); v2.push_back(mesh.verts[x]); }
+            f2.push_back({remap[f.a], remap[f.b], remap[f.c]});
+            if(has_uv) uv2.push_back(mesh.face_uvs[fi]);
+            if(has_id) id2.push_back(mesh.face_ids[fi]);
+        }
+        return;
+    }
 
     for(size_t fi=0; fi<mesh.faces.size(); ++fi){
         if(!face_alive[fi]) continue; // 已删除的面跳过
@@ -197,18 +585,300 @@ bool qem_simplify(Mesh& mesh, const SimplifyOptions& opt, SimplifyReport& rep){
             // 与 Python qem_simplify_ex 一致：仅在面存活时保留对应的 UV triplet。
             uv2.push_back(mesh.face_uvs[fi]);
         }
+        if(has_id) id2.push_back(mesh.face_ids[fi]);
     }
+}
 
-    mesh.verts.swap(v2);
-    mesh.faces.swap(f2);
-    if(has_uv){
-        mesh.face_uvs.swap(uv2);
-    } else {
-        // 若原来尺寸不匹配，说明本次运行未显式填充 UV，保持为空以防误用。
-        mesh.face_uvs.clear();
-    }
+template <class T>
+void Simplifier<T>::snapshot(MeshT<T>& out){
+    bool has_uv = false, has_id = false;
+    compact_into(out.verts, out.faces, out.face_uvs, out.face_ids, has_uv, has_id);
+    if(!has_uv) out.face_uvs.clear();
+    if(!has_id) out.face_ids.clear();
+    clk.lap(rep.stats.t_compact);
+}
 
+template <class T>
+void Simplifier<T>::finish(){
+    if(!mesh.faces.empty()){
+        bool has_uv = false, has_id = false;
+        std::vector<Vec3T<T>>& v2 = ws_verts(ws, mesh);
+        std::vector<std::array<T,6>>& uv2 = ws_uvs(ws, mesh);
+        compact_into(v2, ws.f2, uv2, ws.id2, has_uv, has_id);
+        rep.scratch_bytes = ws.capacity_bytes();
+        mesh.verts.swap(v2);
+        mesh.faces.swap(ws.f2);
+        if(has_uv){
+            mesh.face_uvs.swap(uv2);
+        } else {
+            // 若原来尺寸不匹配，说明本次运行未显式填充 UV，保持为空以防误用。
+            mesh.face_uvs.clear();
+        }
+        if(has_id) mesh.face_ids.swap(ws.id2);
+        else mesh.face_ids.clear();
+    }
     rep.faces_after = mesh.faces.size();
     rep.verts_after = mesh.verts.size();
+    clk.lap(rep.stats.t_compact);
+}
+
+} // namespace
+
+// ---- partitioned mode (opt.partitions) ----
+
+// Smallest mesh worth splitting, in faces per cluster.
+static const size_t kMinClusterFaces = 8192;
+
+// Cluster of every face: the face centroid's cell in a depth-6 octree over the bounding box,
+// cells taken in Morton order and grouped into `parts` consecutive runs of about equal
+// face count. Consecutive Morton cells are spatially compact, so the clusters are too.
+template <class T>
+static std::vector<int> morton_clusters(const MeshT<T>& mesh, int parts, int threads){
+    const size_t nf = mesh.faces.size();
+    const int bits = 6; const size_t cells = (size_t)1 << (3*bits);
+    double lo[3] = {HUGE_VAL, HUGE_VAL, HUGE_VAL}, hi[3] = {-HUGE_VAL, -HUGE_VAL, -HUGE_VAL};
+    for(const auto& p: mesh.verts){ const double c[3]={p.x,p.y,p.z}; for(int k=0;k<3;++k){ lo[k]=std::min(lo[k],c[k]); hi[k]=std::max(hi[k],c[k]); } }
+    double sc[3]; for(int k=0;k<3;++k) sc[k] = hi[k]>lo[k]? (double)(1<<bits)/(hi[k]-lo[k]) : 0.0;
+    auto spread = [](uint32_t x){ uint32_t r=0; for(int i=0;i<bits;++i) r |= ((x>>i)&1u) << (3*i); return r; };
+    std::vector<int> cell(nf);
+    parallel_for(nf, threads, [&](size_t b, size_t e, int){
+        for(size_t fi=b; fi<e; ++fi){ const Tri& f=mesh.faces[fi]; const Vec3 A=to_d(mesh.verts[f.a]), B=to_d(mesh.verts[f.b]), C=to_d(mesh.verts[f.c]);
+            const double c[3]={(A.x+B.x+C.x)/3, (A.y+B.y+C.y)/3, (A.z+B.z+C.z)/3};
+            uint32_t q[3]; for(int k=0;k<3;++k) q[k]=(uint32_t)std::min((double)((1<<bits)-1), std::max(0.0, (c[k]-lo[k])*sc[k]));
+            cell[fi] = (int)(spread(q[0]) | spread(q[1])<<1 | spread(q[2])<<2); }
+    });
+    std::vector<size_t> hist(cells, 0);
+    for(int x: cell) hist[(size_t)x]++;
+    std::vector<int> cl_of(cells);
+    size_t acc=0; int c=0;
+    for(size_t i=0;i<cells;++i){ cl_of[i]=c; acc+=hist[i]; while(c<parts-1 && acc >= nf*(size_t)(c+1)/(size_t)parts) c++; }
+    for(int& x: cell) x = cl_of[(size_t)x];
+    return cell;
+}
+
+template <class T>
+static bool simplify_partitioned(MeshT<T>& mesh, const SimplifyOptions& opt, SimplifyReport& rep, SimplifyWorkspace* wsp, int parts){
+    using clock = std::chrono::steady_clock;
+    auto since = [](clock::time_point t){ return std::chrono::duration<double>(clock::now()-t).count(); };
+    const clock::time_point t_start = clock::now();
+    const int threads = resolve_threads(opt.threads);
+    const size_t faces_in = mesh.faces.size(), verts_in = mesh.verts.size();
+    size_t welded = 0; double t_weld = 0;
+    if(opt.weld_eps>=0){ welded = weld_vertices(mesh, opt.weld_eps, opt.threads); t_weld = since(t_start); }
+
+    clock::time_point t = clock::now();
+    const size_t nf = mesh.faces.size(), nv = mesh.verts.size();
+    const int target = resolve_target((int)nf, opt.ratio, opt.target_faces);
+    const double max_error = resolve_max_error(mesh, opt);  // clusters and the final pass share the global cap
+    const std::vector<int> fc = morton_clusters(mesh, parts, threads);
+    // Faces of each cluster in input order (counting sort).
+    std::vector<size_t> fstart((size_t)parts+1, 0);
+    for(int c: fc) fstart[(size_t)c+1]++;
+    for(int c=0;c<parts;++c) fstart[c+1]+=fstart[c];
+    std::vector<int> forder(nf);
+    { std::vector<size_t> pos(fstart.begin(), fstart.end()-1); for(size_t fi=0; fi<nf; ++fi) forder[pos[fc[fi]]++]=(int)fi; }
+    // A vertex used by faces of two clusters is a seam vertex (owner -2): locked in both.
+    std::vector<int> owner(nv, -1);
+    for(size_t fi=0; fi<nf; ++fi){ const Tri& f=mesh.faces[fi]; for(int x: {f.a,f.b,f.c}){ int& o=owner[x]; if(o==-1) o=fc[fi]; else if(o!=fc[fi]) o=-2; } }
+    std::vector<int> seam_id(nv, -1); int nseam=0;
+    for(size_t v=0; v<nv; ++v) if(owner[v]==-2) seam_id[v]=nseam++;
+    const bool has_uv = mesh.face_uvs.size() == nf, has_id = mesh.face_ids.size() == nf;
+    double t_partition = since(t);
+
+    // Each cluster becomes its own mesh: its seam vertices first (ascending global index,
+    // locked), then its interior vertices in order of first use. Interior vertices belong to
+    // one cluster only, so the shared `local` map is written race-free.
+    struct Cluster { MeshT<T> m; std::vector<int> seam; SimplifyReport rep; };
+    std::vector<Cluster> cls((size_t)parts);
+    std::vector<int> local(nv, -1);
+    t = clock::now();
+    parallel_for((size_t)parts, threads, [&](size_t b, size_t e, int){
+        for(size_t c=b; c<e; ++c){
+            const size_t f0=fstart[c], f1=fstart[c+1];
+            if(f0==f1) continue;
+            Cluster& C = cls[c]; MeshT<T>& m = C.m;
+            for(size_t i=f0; i<f1; ++i){ const Tri& f=mesh.faces[forder[i]]; for(int x: {f.a,f.b,f.c}) if(owner[x]==-2) C.seam.push_back(x); }
+            std::sort(C.seam.begin(), C.seam.end()); C.seam.erase(std::unique(C.seam.begin(), C.seam.end()), C.seam.end());
+            for(int x: C.seam) m.verts.push_back(mesh.verts[x]);
+            auto lid = [&](int x){
+                if(owner[x]==-2) return (int)(std::lower_bound(C.seam.begin(), C.seam.end(), x) - C.seam.begin());
+                int& l=local[x]; if(l<0){ l=(int)m.verts.size(); m.verts.push_back(mesh.verts[x]); } return l; };
+            int seam_faces=0;
+            m.faces.reserve(f1-f0); if(has_uv) m.face_uvs.reserve(f1-f0); if(has_id) m.face_ids.reserve(f1-f0);
+            for(size_t i=f0; i<f1; ++i){ const Tri& f=mesh.faces[forder[i]];
+                Tri g{lid(f.a), lid(f.b), lid(f.c)}; m.faces.push_back(g);
+                seam_faces += owner[f.a]==-2 || owner[f.b]==-2 || owner[f.c]==-2;
+                if(has_uv) m.face_uvs.push_back(mesh.face_uvs[forder[i]]);
+                if(has_id) m.face_ids.push_back(mesh.face_ids[forder[i]]); }
+            std::vector<char> lock(m.verts.size(), 0);
+            std::fill(lock.begin(), lock.begin()+(long)C.seam.size(), (char)1);
+
+            // Proportional share of the target (cumulative rounding, so the shares sum to it),
+            // plus the faces touching the seam: the final pass gets that much room to thin the
+            // locked band back out to the density around it.
+            const int n = (int)(f1-f0);
+            const int share = (int)((long long)target*(long long)f1/(long long)nf - (long long)target*(long long)f0/(long long)nf);
+            const int goal = std::min(n, share + seam_faces);
+            SimplifyOptions lo = opt;
+            lo.threads = 1; lo.weld_eps = -1.0; lo.partitions = 0;
+            lo.max_error = max_error; lo.max_error_relative = false;
+            lo.reorder = false;              // only the final pass's output order matters
+            lo.progress_interval = INT_MAX;  // concurrent clusters would interleave progress lines
+            lo.progress = nullptr;           //   and call the hook from several threads; cancel is still polled
+            Simplifier<T> s(m, lo, C.rep, nullptr);
+            s.lock(lock.data());
+            if(s.setup()){
+                const int mc = opt.max_collapses>0? (int)((long long)opt.max_collapses*n/(long long)nf) : n - goal;
+                s.collapse_until(goal, std::max(mc, 0));
+            }
+            s.finish();
+        }
+    }, 1);
+    const double t_clusters = since(t);
+
+    // Stitch: seam vertices keep one shared copy (they never moved), interior vertices follow
+    // cluster by cluster.
+    t = clock::now();
+    MeshT<T> out;
+    out.verts.resize((size_t)nseam);
+    for(size_t v=0; v<nv; ++v) if(seam_id[v]>=0) out.verts[(size_t)seam_id[v]] = mesh.verts[v];
+    size_t cl_collapses=0;
+    for(const Cluster& C: cls){
+        if(C.m.faces.empty()) continue;
+        const int k=(int)C.seam.size(), base=(int)out.verts.size()-k;
+        out.verts.insert(out.verts.end(), C.m.verts.begin()+k, C.m.verts.end());
+        auto gid = [&](int i){ return i<k? seam_id[C.seam[i]] : base+i; };
+        for(const Tri& f: C.m.faces) out.faces.push_back({gid(f.a), gid(f.b), gid(f.c)});
+        if(has_uv) out.face_uvs.insert(out.face_uvs.end(), C.m.face_uvs.begin(), C.m.face_uvs.end());
+        if(has_id) out.face_ids.insert(out.face_ids.end(), C.m.face_ids.begin(), C.m.face_ids.end());
+        cl_collapses += C.rep.stats.collapses;
+    }
+    mesh = std::move(out);
+    t_partition += since(t);
+
+    // Final pass over everything, seams included, down to the global target.
+    SimplifyOptions fo = opt;
+    fo.weld_eps = -1.0; fo.partitions = 0;
+    fo.max_error = max_error; fo.max_error_relative = false;
+    if(opt.time_limit>0) fo.time_limit = std::max(1e-9, opt.time_limit - since(t_start));
+    bool cancelled = false;
+    for(const Cluster& C: cls) cancelled = cancelled || C.rep.stats.cancelled;
+    Simplifier<T> s(mesh, fo, rep, wsp);
+    if(s.setup() && !cancelled){
+        int mc = opt.max_collapses>0? opt.max_collapses - (int)cl_collapses : s.faces_now() - target;
+        s.collapse_until(target, std::max(mc, 0));
+    }
+    s.finish();
+
+    // Report the whole run: input counts, cluster counters folded into the final pass's.
+    SimplifyStats& st = rep.stats;
+    rep.faces_before = faces_in; rep.verts_before = verts_in;
+    st.welded_verts = welded;
+    size_t cl_scratch = 0;
+    for(const Cluster& C: cls){
+        if(C.m.faces.empty()) continue;
+        const SimplifyStats& cs = C.rep.stats;
+        st.clusters++;
+        st.collapses += cs.collapses; st.heap_pushes += cs.heap_pushes; st.stale_pops += cs.stale_pops;
+        st.solve_fallbacks += cs.solve_fallbacks; st.degenerate_faces += cs.degenerate_faces;
+        st.flip_rejects += cs.flip_rejects; st.link_rejects += cs.link_rejects;
+        st.peak_heap = std::max(st.peak_heap, cs.peak_heap);
+        st.time_limited = st.time_limited || cs.time_limited;
+        st.cancelled = st.cancelled || cs.cancelled;
+        st.error_limited = st.error_limited || cs.error_limited;
+        rep.final_error = std::max(rep.final_error, C.rep.final_error);
+        cl_scratch += C.rep.scratch_bytes;
+    }
+    rep.scratch_bytes = std::max(rep.scratch_bytes, cl_scratch);
+    if(opt.collect_stats){ st.t_weld = t_weld; st.t_partition = t_partition; st.t_clusters = t_clusters; }
+    return true;
+}
+
+int resolve_partitions(const SimplifyOptions& opt, size_t faces){
+    if(opt.partitions>=0) return opt.partitions;
+    if(!opt.deterministic) return resolve_threads(opt.threads);
+    return (int)std::min<size_t>((size_t)kDeterministicMaxClusters, std::max<size_t>(1, faces/kDeterministicClusterFaces));
+}
+
+template <class T>
+static bool simplify_impl(MeshT<T>& mesh, const SimplifyOptions& opt, SimplifyReport& rep, SimplifyWorkspace* wsp, ProgressiveMesh* pm){
+    if(opt.method==SimplifyMethod::Cluster && !pm){
+        cluster_simplify(mesh, opt, rep);
+        if(opt.reorder && !mesh.faces.empty()) reorder_for_vertex_cache(mesh);
+        rep.verts_after = mesh.verts.size();
+        return true;
+    }
+    const int parts = resolve_partitions(opt, mesh.faces.size());
+    if(parts>1 && !pm && mesh.faces.size() >= (size_t)parts*kMinClusterFaces)
+        return simplify_partitioned(mesh, opt, rep, wsp, parts);
+    Simplifier<T> s(mesh, opt, rep, wsp, pm);
+    if(s.setup()){
+        // target faces (after the optional weld)
+        int faces0 = s.faces_now();
+        int target = resolve_target(faces0, opt.ratio, opt.target_faces);
+        int max_collapses = opt.max_collapses>0? opt.max_collapses : (faces0 - target);
+        if(max_collapses<0) max_collapses=0;
+        s.collapse_until(target, max_collapses);
+    }
+    s.finish();
+    return true;
+}
+
+template <class T>
+static bool lods_impl(const MeshT<T>& mesh, const std::vector<LodTarget>& targets, const SimplifyOptions& opt,
+                      std::vector<MeshT<T>>& lods, SimplifyReport& rep, SimplifyWorkspace* wsp){
+    lods.assign(targets.size(), MeshT<T>{});
+    MeshT<T> work = mesh;
+    Simplifier<T> s(work, opt, rep, wsp);
+    if(s.setup()){
+        const int faces0 = s.faces_now();
+        std::vector<int> want(targets.size());
+        for(size_t i=0;i<targets.size();++i) want[i] = resolve_target(faces0, targets[i].ratio, targets[i].target_faces);
+        // Visit targets from largest to smallest; the collapse loop only ever goes forward.
+        std::vector<size_t> order(targets.size());
+        for(size_t i=0;i<order.size();++i) order[i]=i;
+        std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b){ return want[a] > want[b]; });
+        const int max_collapses = opt.max_collapses>0? opt.max_collapses : faces0;
+        for(size_t i: order){
+            s.collapse_until(want[i], max_collapses);
+            s.snapshot(lods[i]);
+        }
+    } else {
+        for(auto& l: lods) l = work;
+    }
+    s.finish();  // fills the report; `work` ends at the smallest target
     return true;
 }
+
+bool qem_simplify(Mesh& mesh, const SimplifyOptions& opt, SimplifyReport& rep, SimplifyWorkspace* wsp, ProgressiveMesh* pm){
+    return simplify_impl(mesh, opt, rep, wsp, pm);
+}
+
+bool qem_simplify(MeshF& mesh, const SimplifyOptions& opt, SimplifyReport& rep, SimplifyWorkspace* wsp){
+    return simplify_impl(mesh, opt, rep, wsp, nullptr);
+}
+
+bool qem_simplify_locked(Mesh& mesh, const std::vector<char>& locked, const SimplifyOptions& opt, SimplifyReport& rep, SimplifyWorkspace* wsp){
+    if(locked.size()!=mesh.verts.size()) return false;
+    SimplifyOptions lo = opt;
+    lo.weld_eps = -1.0; lo.reorder = false;  // both would renumber the vertices the mask refers to
+    Simplifier<double> s(mesh, lo, rep, wsp);
+    s.lock(locked.data());
+    if(s.setup()){
+        const int faces0 = s.faces_now();
+        const int target = resolve_target(faces0, lo.ratio, lo.target_faces);
+        s.collapse_until(target, std::max(lo.max_collapses>0? lo.max_collapses : faces0 - target, 0));
+    }
+    s.finish();
+    return true;
+}
+
+bool qem_simplify_lods(const Mesh& mesh, const std::vector<LodTarget>& targets, const SimplifyOptions& opt,
+                       std::vector<Mesh>& lods, SimplifyReport& rep, SimplifyWorkspace* wsp){
+    return lods_impl(mesh, targets, opt, lods, rep, wsp);
+}
+
+bool qem_simplify_lods(const MeshF& mesh, const std::vector<LodTarget>& targets, const SimplifyOptions& opt,
+                       std::vector<MeshF>& lods, SimplifyReport& rep, SimplifyWorkspace* wsp){
+    return lods_impl(mesh, targets, opt, lods, rep, wsp);
+}
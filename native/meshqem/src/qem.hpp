@@ -1,22 +1,50 @@
 #pragma once
 #include "mesh.hpp"
+#include "quadric.hpp"   // Quadric: packed symmetric 4x4 (10 doubles) and its kernels
 #include <vector>
 #include <array>
-#include <queue>
-
-// Quadric — a 4x4 symmetric matrix representing the squared distance to a set
-// of planes (from triangles' plane equations). We store in row-major order.
-// The error at a homogeneous point v'=[x,y,z,1] is: E(v') = v'^T Q v'.
-struct Quadric { double m[16]; };
+#include <atomic>
+#include <functional>
 
 // Edge candidate stored in a min-heap. We invert the comparator to get a min-heap
-// using std::priority_queue (which is a max-heap by default).
+// using the std heap algorithms (which build a max-heap by default).
+// ver_u/ver_v snapshot the endpoints' version stamps at push time; the collapse loop
+// bumps a vertex's stamp whenever it changes, so a mismatch marks the entry stale.
+// The position the cost was evaluated at is stored with it and applied on collapse.
+// Equal costs are ordered by (u, v), so the pop order of live entries is a total order that
+// does not depend on the heap's layout (thread count, std library, sweep history).
 struct EdgeCand {
     int u, v;       // vertex indices forming the edge (u<v canonicalized before push)
-    double cost;    // collapse cost estimated from QEM at optimal/midpoint position
-    bool operator<(const EdgeCand& o) const { return cost > o.cost; } // min-heap via greater
+    int ver_u, ver_v; // endpoint version stamps when this entry was pushed
+    double cost;    // QEM cost of collapsing to (x,y,z)
+    double x, y, z; // placement of the merged vertex (SimplifyOptions::placement)
+    bool operator<(const EdgeCand& o) const { // min-heap via greater
+        return cost > o.cost || (cost == o.cost && (u > o.u || (u == o.u && v > o.v)));
+    }
+};
+
+// Algorithm behind qem_simplify: edge-collapse QEM, or uniform-grid vertex clustering
+// (cluster.hpp; linear-time, approximate target, for previews).
+enum class SimplifyMethod { Qem, Cluster };
+
+// Where a collapsed edge's merged vertex goes:
+// - Optimal: the minimizer of the summed quadric; where that system is singular (flat or
+//   straight regions), the cheapest of the midpoint and the two endpoints.
+// - Midpoint: always the edge midpoint.
+// - Endpoint: the cheaper endpoint; vertex positions are a subset of the input.
+enum class Placement { Optimal, Midpoint, Endpoint };
+
+// Snapshot handed to SimplifyOptions::progress.
+struct SimplifyProgress {
+    int    collapses = 0;         // collapses so far in this collapse loop
+    int    faces = 0;             // current face count
+    int    target = 0;            // face count the loop is heading for
+    double elapsed = 0;           // seconds since the collapse loop started
 };
 
+// Progress hook: return false to cancel the run.
+using ProgressFn = std::function<bool(const SimplifyProgress&)>;
+
 // Tuning knobs for the simplification run. See src/main.cpp for CLI wiring.
 struct SimplifyOptions {
     double ratio = 0.5;           // target face ratio (0..1]; used when target_faces<0
@@ -24,6 +52,74 @@ struct SimplifyOptions {
     int    max_collapses = -1;    // safety cap on number of edge collapses; default derived from target
     double time_limit = -1.0;     // per-mesh time limit in seconds; <0 disables
     int    progress_interval = 20000; // emit a progress line every N collapses
+    int    threads = 1;             // worker threads for the setup phase; <=0 = all hardware threads
+    bool   collect_stats = false;   // fill SimplifyReport::stats (phase timings); counters are always kept
+    double weld_eps = -1.0;         // >=0: weld vertices within this distance first (weld.hpp); <0 disables
+    int    partitions = 0;          // >1: collapse this many spatial clusters concurrently, then a boundary
+                                    // pass (see qem_simplify); <0: one cluster per thread; 0/1: serial
+    bool   deterministic = false;   // same output for any thread count and scheduling: partitions<0 picks
+                                    // the cluster count from the face count instead (resolve_partitions)
+    SimplifyMethod method = SimplifyMethod::Qem;
+    Placement placement = Placement::Optimal;
+    bool   reorder = false;         // output faces in vertex-cache (Tipsify) order and vertices in first-use
+                                    // order, dropping unreferenced vertices (reorder.hpp); LODs extracted
+                                    // from a ProgressiveMesh are not reordered
+    double max_error = -1.0;        // >=0: also stop once the cheapest collapse costs more than max_error^2
+                                    // (QEM cost: summed squared distances to the merged planes); <0 disables
+    bool   max_error_relative = false; // max_error is a fraction of the bounding-box diagonal
+    double boundary_weight = 0.0;   // >0: penalty plane along each open-boundary edge, this many times the
+                                    // weight of a face plane (e.g. 100); keeps borders from shrinking/cracking
+    double seam_weight = 0.0;       // >0: the same along face-varying UV seams (edges whose two faces
+                                    // disagree on an endpoint's UV); needs face_uvs. 0 = off (no extra pass)
+    bool   guard = true;            // reject collapses that would flip a face or break the link condition
+                                    // (non-manifold edge); rejected edges are re-queued at a higher cost
+    // Called every progress_interval collapses in place of the stderr progress line. The
+    // collapse loop also polls `cancel` and time_limit every kPollCollapses iterations rather
+    // than every collapse. A cancelled run stops like a time-limited one: the mesh is left
+    // at the state reached and stats.cancelled is set.
+    ProgressFn progress;
+    const std::atomic<bool>* cancel = nullptr;
+};
+
+// Collapse-loop iterations between cancel / time_limit checks.
+constexpr int kPollCollapses = 256;
+
+// opt.deterministic with opt.partitions < 0: one cluster per this many faces, at most
+// kDeterministicMaxClusters.
+constexpr size_t kDeterministicClusterFaces = 131072;
+constexpr int kDeterministicMaxClusters = 64;
+
+// Cluster count opt.partitions asks for on a mesh of `faces` faces: partitions itself, or
+// for partitions < 0 one per thread (resolve_threads), or with opt.deterministic one per
+// kDeterministicClusterFaces. 0 or 1 means a serial run.
+int resolve_partitions(const SimplifyOptions& opt, size_t faces);
+
+// Per-run diagnostics. Timings are seconds and stay 0 unless opt.collect_stats is set.
+struct SimplifyStats {
+    double t_weld = 0;            // optional vertex weld (opt.weld_eps)
+    double t_quadrics = 0;        // zero-area test + per-vertex quadric gather
+    double t_adjacency = 0;       // vertex->face and vertex->neighbor lists
+    double t_heap_init = 0;       // initial candidates + heapify
+    double t_collapse = 0;        // collapse loop
+    double t_compact = 0;         // final vertex/face compaction
+    double t_partition = 0;       // partitioned mode: cluster split, extraction and stitching
+    double t_clusters = 0;        // partitioned mode: concurrent per-cluster runs (wall time)
+    double t_grid = 0;            // cluster method: grid sizing and vertex->cell assignment
+    size_t collapses = 0;
+    size_t heap_pushes = 0;       // including the initial candidates
+    size_t stale_pops = 0;        // popped entries discarded by the version check
+    size_t solve_fallbacks = 0;   // singular 3x3 systems that fell back to midpoint/endpoints
+    size_t degenerate_faces = 0;  // zero-area input faces dropped during setup
+    size_t welded_verts = 0;      // vertices merged away by the weld pass
+    size_t boundary_edges = 0;    // edges given a boundary penalty plane (opt.boundary_weight)
+    size_t seam_edges = 0;        // edges given UV-seam penalty planes (opt.seam_weight)
+    size_t flip_rejects = 0;      // collapses refused by opt.guard because a face would flip
+    size_t link_rejects = 0;      // collapses refused by opt.guard because of the link condition
+    size_t peak_heap = 0;         // largest heap size (entries, live + stale)
+    size_t clusters = 0;          // partitioned mode: clusters simplified concurrently (0 = serial run)
+    bool   time_limited = false;  // the run stopped on opt.time_limit
+    bool   cancelled = false;     // the run stopped on opt.cancel or a false return from opt.progress
+    bool   error_limited = false; // the run stopped on opt.max_error
 };
 
 // Summary counters emitted to stdout by main().
@@ -32,8 +128,72 @@ struct SimplifyReport {
     size_t faces_after = 0;
     size_t verts_before = 0;
     size_t verts_after = 0;
+    size_t scratch_bytes = 0;     // peak scratch memory held by the run's workspace
+    bool   from_cache = false;    // result served from a MeshCache / disk cache (mesh_cache.hpp); stats stay 0
+    double final_error = 0;       // sqrt of the largest collapse cost applied, in mesh units (0 if none)
+    SimplifyStats stats;
+};
+
+struct SimplifyWorkspace;         // reusable scratch buffers, see workspace.hpp
+struct ProgressiveMesh;           // base mesh + collapse log, see progressive.hpp
+
+// One level of a LOD chain; same rules as SimplifyOptions (target_faces>0 wins over ratio).
+struct LodTarget {
+    double ratio = 0.5;
+    int    target_faces = -1;
 };
 
 // In-place simplification: mutates `mesh` to contain the decimated geometry.
 // Returns true on success and fills `rep` with before/after counts.
-bool qem_simplify(Mesh& mesh, const SimplifyOptions& opt, SimplifyReport& rep);
+// Pass a workspace to reuse its scratch buffers across calls; nullptr uses a temporary one.
+// Pass `pm` to also record the base mesh and the ordered collapse log (progressive.hpp).
+//
+// With opt.partitions > 1 (or < 0) large meshes are split into Morton-ordered clusters of
+// equal face count. Each cluster is simplified concurrently toward its proportional share
+// of the target with the vertices it shares with other clusters locked; the clusters are
+// then stitched back and a final serial pass over the whole mesh (now free to collapse
+// the former cluster seams) reaches the target. Output is comparable to, not identical
+// with, a serial run. Small meshes and runs that record `pm` always run serially.
+//
+// Output is a pure function of the input and the options, whatever opt.threads and the
+// scheduling of the setup phases or clusters: every parallel step writes fixed ranges and
+// reduces in a fixed order, and heap ties are broken by vertex index (EdgeCand). The one
+// exception is partitions < 0, whose cluster count follows the thread count unless
+// opt.deterministic is set. opt.time_limit, opt.cancel and a cancelling progress hook stop
+// a run at a timing-dependent point and are outside this guarantee (stats.time_limited /
+// stats.cancelled tell). Builds with different SIMD paths (quadric.hpp) may differ in the
+// last bits.
+//
+// opt.max_error turns the face target into a floor: the loop stops at whichever comes first,
+// the target or a cheapest candidate costing more than max_error^2. Set ratio/target_faces
+// to 0 to stop on error alone. rep.final_error reports the error reached. In partitioned mode
+// the final pass measures cost against the stitched cluster output, not the input, so the
+// total deviation can exceed max_error there. The cluster method ignores it.
+bool qem_simplify(Mesh& mesh, const SimplifyOptions& opt, SimplifyReport& rep, SimplifyWorkspace* ws = nullptr,
+                  ProgressiveMesh* pm = nullptr);
+
+// Float32 storage (MeshF), for callers whose points are float anyway (USD, numpy float32):
+// positions and UVs take half the memory of Mesh and no double copy of them is needed.
+// Quadrics, costs and new positions are still computed in double, so the result differs
+// from a Mesh run only by the rounding of the inputs and of each placed vertex. There is
+// no progressive log for MeshF.
+bool qem_simplify(MeshF& mesh, const SimplifyOptions& opt, SimplifyReport& rep, SimplifyWorkspace* ws = nullptr);
+
+// Serial run with the vertices flagged in `locked` (one entry per vertex) pinned: they are
+// never collapsed or moved, so a piece of a larger mesh can be simplified on its own and
+// stitched back along its border (stream.hpp). Surviving vertices keep their relative order;
+// opt.weld_eps, opt.reorder, opt.partitions and opt.method are ignored. False if the mask
+// does not match mesh.verts.
+bool qem_simplify_locked(Mesh& mesh, const std::vector<char>& locked, const SimplifyOptions& opt, SimplifyReport& rep,
+                         SimplifyWorkspace* ws = nullptr);
+
+// LOD chain in a single pass: setup (quadrics, adjacency, heap) runs once, then the collapse
+// loop stops at each target in turn and a compacted snapshot (verts, faces, aligned face_uvs)
+// is written to lods[i], in the order of `targets`. `mesh` is left untouched.
+// opt.ratio/target_faces are ignored; opt.max_collapses caps the whole chain and
+// opt.time_limit the whole loop (later levels then equal the last reached state).
+// `rep` describes the run down to the smallest target.
+bool qem_simplify_lods(const Mesh& mesh, const std::vector<LodTarget>& targets, const SimplifyOptions& opt,
+                       std::vector<Mesh>& lods, SimplifyReport& rep, SimplifyWorkspace* ws = nullptr);
+bool qem_simplify_lods(const MeshF& mesh, const std::vector<LodTarget>& targets, const SimplifyOptions& opt,
+                       std::vector<MeshF>& lods, SimplifyReport& rep, SimplifyWorkspace* ws = nullptr);
@@ -0,0 +1,122 @@
+// quadric.hpp — Packed symmetric quadric and its hot kernels (header-only so they inline).
+//
+// A plane quadric K = p p^T (p = [a,b,c,d]) is symmetric, so only the upper triangle is
+// stored, row by row:
+//
+//     | m0 m1 m2 m3 |      m0=aa m1=ab m2=ac m3=ad
+//     |    m4 m5 m6 |      m4=bb m5=bc m6=bd
+//     |       m7 m8 |      m7=cc m8=cd
+//     |          m9 |      m9=dd
+//
+// 10 doubles (80 bytes) instead of 16 (128 bytes). The kernels below have SSE2 / AVX /
+// NEON variants selected at compile time; the scalar loop is the portable reference.
+// Build with -DMESHQEM_NATIVE_ARCH=ON (or any -mavx) to enable the 256-bit paths.
+//
+#pragma once
+#include <cmath>
+#include <utility>
+#if defined(__AVX__) || defined(__SSE2__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+// Quadric — the squared distance to a set of planes; E(v') = v'^T Q v' at v'=[x,y,z,1].
+// 16-byte alignment keeps the size at exactly 80 bytes while allowing aligned SSE/NEON access.
+struct alignas(16) Quadric { double m[10]; };
+
+static inline void q_zero(Quadric& Q){ for(int i=0;i<10;++i) Q.m[i]=0; }
+
+// A += B
+static inline void q_add(Quadric& A, const Quadric& B){
+#if defined(__AVX__)
+    _mm256_storeu_pd(A.m+0, _mm256_add_pd(_mm256_loadu_pd(A.m+0), _mm256_loadu_pd(B.m+0)));
+    _mm256_storeu_pd(A.m+4, _mm256_add_pd(_mm256_loadu_pd(A.m+4), _mm256_loadu_pd(B.m+4)));
+    _mm_store_pd(A.m+8, _mm_add_pd(_mm_load_pd(A.m+8), _mm_load_pd(B.m+8)));
+#elif defined(__SSE2__)
+    for(int i=0;i<10;i+=2) _mm_store_pd(A.m+i, _mm_add_pd(_mm_load_pd(A.m+i), _mm_load_pd(B.m+i)));
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    for(int i=0;i<10;i+=2) vst1q_f64(A.m+i, vaddq_f64(vld1q_f64(A.m+i), vld1q_f64(B.m+i)));
+#else
+    for(int i=0;i<10;++i) A.m[i]+=B.m[i];
+#endif
+}
+
+// A + B
+static inline Quadric q_sum(const Quadric& A, const Quadric& B){ Quadric C=A; q_add(C,B); return C; }
+
+// Build a quadric from plane parameters a,b,c,d (ax + by + cz + d = 0): K = p p^T.
+static inline Quadric plane_quadric(double a, double b, double c, double d){
+    Quadric K;
+#if defined(__AVX__)
+    __m256d p = _mm256_set_pd(d,c,b,a);
+    _mm256_storeu_pd(K.m+0, _mm256_mul_pd(_mm256_set1_pd(a), p));                   // aa ab ac ad
+    _mm256_storeu_pd(K.m+4, _mm256_mul_pd(_mm256_set_pd(c,b,b,b), _mm256_set_pd(c,d,c,b))); // bb bc bd cc
+    _mm_store_pd(K.m+8, _mm_mul_pd(_mm_set_pd(d,c), _mm_set1_pd(d)));                // cd dd
+#else
+    K.m[0]=a*a; K.m[1]=a*b; K.m[2]=a*c; K.m[3]=a*d;
+    K.m[4]=b*b; K.m[5]=b*c; K.m[6]=b*d;
+    K.m[7]=c*c; K.m[8]=c*d;
+    K.m[9]=d*d;
+#endif
+    return K;
+}
+
+// Evaluate v^T Q v at v=[x,y,z,1], written as a dot product of the 10 coefficients with
+// the monomials [xx, 2xy, 2xz, 2x, yy, 2yz, 2y, zz, 2z, 1].
+static inline double quadric_eval(const Quadric& Q, const double v[4]){
+    const double x=v[0], y=v[1], z=v[2];
+#if defined(__AVX__)
+    __m256d w0 = _mm256_mul_pd(_mm256_set_pd(2*x,2*x,2*x,x), _mm256_set_pd(1,z,y,x));
+    __m256d w1 = _mm256_mul_pd(_mm256_set_pd(z,2*y,2*y,y), _mm256_set_pd(z,1,z,y));
+    __m256d s  = _mm256_add_pd(_mm256_mul_pd(_mm256_loadu_pd(Q.m+0), w0), _mm256_mul_pd(_mm256_loadu_pd(Q.m+4), w1));
+    __m128d h  = _mm_add_pd(_mm256_castpd256_pd128(s), _mm256_extractf128_pd(s,1));
+    h = _mm_add_pd(h, _mm_mul_pd(_mm_load_pd(Q.m+8), _mm_set_pd(1,2*z)));
+    return _mm_cvtsd_f64(_mm_add_sd(h, _mm_unpackhi_pd(h,h)));
+#elif defined(__SSE2__)
+    __m128d s = _mm_mul_pd(_mm_load_pd(Q.m+0), _mm_set_pd(2*x*y, x*x));
+    s = _mm_add_pd(s, _mm_mul_pd(_mm_load_pd(Q.m+2), _mm_set_pd(2*x, 2*x*z)));
+    s = _mm_add_pd(s, _mm_mul_pd(_mm_load_pd(Q.m+4), _mm_set_pd(2*y*z, y*y)));
+    s = _mm_add_pd(s, _mm_mul_pd(_mm_load_pd(Q.m+6), _mm_set_pd(z*z, 2*y)));
+    s = _mm_add_pd(s, _mm_mul_pd(_mm_load_pd(Q.m+8), _mm_set_pd(1, 2*z)));
+    return _mm_cvtsd_f64(_mm_add_sd(s, _mm_unpackhi_pd(s,s)));
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    const double w[10]={x*x,2*x*y,2*x*z,2*x,y*y,2*y*z,2*y,z*z,2*z,1};
+    float64x2_t s = vmulq_f64(vld1q_f64(Q.m), vld1q_f64(w));
+    for(int i=2;i<10;i+=2) s = vfmaq_f64(s, vld1q_f64(Q.m+i), vld1q_f64(w+i));
+    return vaddvq_f64(s);
+#else
+    const double w[10]={x*x,2*x*y,2*x*z,2*x,y*y,2*y*z,2*y,z*z,2*z,1};
+    double s=0; for(int i=0;i<10;++i) s+=Q.m[i]*w[i];
+    return s;
+#endif
+}
+
+// Split Q into the 3x3 system A x = b whose solution minimizes v^T Q v
+// (A = upper-left 3x3 block, b = -Q[0:3,3]).
+static inline void quadric_system(const Quadric& Q, double A[9], double b[3]){
+    A[0]=Q.m[0]; A[1]=Q.m[1]; A[2]=Q.m[2];
+    A[3]=Q.m[1]; A[4]=Q.m[4]; A[5]=Q.m[5];
+    A[6]=Q.m[2]; A[7]=Q.m[5]; A[8]=Q.m[7];
+    b[0]=-Q.m[3]; b[1]=-Q.m[6]; b[2]=-Q.m[8];
+}
+
+// Solve a 3x3 linear system A x = b with partial pivoting; returns false if near-singular.
+// Used to find the point minimizing v'^T Q v' where Q is a merged quadric of an edge's endpoints.
+static inline bool solve3(const double A[9], const double b[3], double x[3]){
+    double M[3][4]={{A[0],A[1],A[2],b[0]},{A[3],A[4],A[5],b[1]},{A[6],A[7],A[8],b[2]}};
+    for(int i=0;i<3;++i){
+        // Pivot on the largest absolute value in the current column to improve stability.
+        int piv=i; double pv=std::abs(M[i][i]);
+        for(int r=i+1;r<3;++r){ double av=std::abs(M[r][i]); if(av>pv){piv=r; pv=av;} }
+        if(pv<1e-12) return false; // treat as singular; caller will fallback to midpoint
+        if(piv!=i) for(int c=0;c<4;++c) std::swap(M[i][c],M[piv][c]);
+        // Normalize the pivot row.
+        double div=M[i][i]; for(int c=0;c<4;++c) M[i][c]/=div;
+        // Eliminate rows below.
+        for(int r=i+1;r<3;++r){ double f=M[r][i]; for(int c=i;c<4;++c) M[r][c]-=f*M[i][c]; }
+    }
+    // Back substitution.
+    for(int i=2;i>=0;--i){ double s=M[i][3]; for(int c=i+1;c<3;++c) s-=M[i][c]*x[c]; x[i]=s; }
+    return true;
+}
@@ -0,0 +1,53 @@
+// reorder.cpp — FIFO cache simulation and the standalone Mesh reorder.
+
+#include "reorder.hpp"
+#include <utility>
+
+double vertex_cache_acmr(const std::vector<Tri>& faces, size_t nv, int cache_size) {
+    if (faces.empty()) return 0.0;
+    std::vector<long long> in_at(nv, -(1LL << 40));  // "time" each vertex entered the FIFO
+    long long misses = 0;
+    for (const Tri& f : faces)
+        for (int v : {f.a, f.b, f.c})
+            if (misses - in_at[(size_t)v] >= cache_size) in_at[(size_t)v] = misses++;
+    return (double)misses / (double)faces.size();
+}
+
+template <class T>
+void reorder_for_vertex_cache(MeshT<T>& mesh, int cache_size) {
+    const size_t nf = mesh.faces.size(), nv = mesh.verts.size();
+    // vertex -> faces, CSR
+    std::vector<int> start(nv + 1, 0), inc(3 * nf);
+    for (const Tri& f : mesh.faces) { start[(size_t)f.a + 1]++; start[(size_t)f.b + 1]++; start[(size_t)f.c + 1]++; }
+    for (size_t v = 0; v < nv; ++v) start[v + 1] += start[v];
+    {
+        std::vector<int> pos(start.begin(), start.end() - 1);
+        for (size_t fi = 0; fi < nf; ++fi) { const Tri& f = mesh.faces[fi]; for (int v : {f.a, f.b, f.c}) inc[(size_t)pos[(size_t)v]++] = (int)fi; }
+    }
+    TipsifyScratch sc;
+    std::vector<int> order;
+    tipsify_order(mesh.faces.data(), nf, nv, [&](int v) { return std::make_pair(inc.data() + start[(size_t)v], inc.data() + start[(size_t)v + 1]); },
+                  nullptr, cache_size, sc, order);
+
+    const bool has_uv = mesh.face_uvs.size() == nf, has_id = mesh.face_ids.size() == nf;
+    std::vector<int> remap(nv, -1);
+    std::vector<Vec3T<T>> verts; verts.reserve(nv);
+    std::vector<Tri> faces; faces.reserve(nf);
+    std::vector<std::array<T, 6>> uvs; if (has_uv) uvs.reserve(nf);
+    std::vector<int> ids; if (has_id) ids.reserve(nf);
+    auto id = [&](int v) { int& r = remap[(size_t)v]; if (r < 0) { r = (int)verts.size(); verts.push_back(mesh.verts[(size_t)v]); } return r; };
+    for (int fi : order) {
+        const Tri& f = mesh.faces[(size_t)fi];
+        const int a = id(f.a), b = id(f.b), c = id(f.c);
+        faces.push_back(Tri{a, b, c});
+        if (has_uv) uvs.push_back(mesh.face_uvs[(size_t)fi]);
+        if (has_id) ids.push_back(mesh.face_ids[(size_t)fi]);
+    }
+    mesh.verts.swap(verts);
+    mesh.faces.swap(faces);
+    if (has_uv) mesh.face_uvs.swap(uvs); else mesh.face_uvs.clear();
+    if (has_id) mesh.face_ids.swap(ids); else mesh.face_ids.clear();
+}
+
+template void reorder_for_vertex_cache(Mesh&, int);
+template void reorder_for_vertex_cache(MeshF&, int);
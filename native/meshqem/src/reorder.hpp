@@ -0,0 +1,91 @@
+// reorder.hpp — Vertex-cache friendly face order and first-use vertex order for output meshes.
+//
+// Simplified meshes come out of compaction in surviving input order, which after heavy
+// decimation scatters each face's corners across the vertex array. With
+// SimplifyOptions::reorder the output is instead:
+// - faces in Tipsify order (Sander, Nehab, Barczak 2007): fan out around a "fanning"
+//   vertex, then continue from the neighbour that is still in a simulated FIFO cache of
+//   kReorderCacheSize entries and has the fewest faces left; dead ends fall back to recently
+//   used vertices, then to a linear cursor. Linear in faces + vertices, no tuning tables.
+// - vertices renumbered in order of first use by that face stream, so vertex fetches run
+//   forward through memory (downstream writers and renderers both benefit).
+// qem.cpp runs this inside compaction over the collapse loop's vertex->face index, so no
+// extra adjacency is built; reorder_for_vertex_cache() does the same for any Mesh.
+//
+#pragma once
+#include "mesh.hpp"
+#include <cstddef>
+#include <vector>
+
+// Simulated post-transform cache size. Deliberately a little small: orders tuned for 16
+// entries still do well on larger caches, the reverse is not true.
+constexpr int kReorderCacheSize = 16;
+
+struct TipsifyScratch {
+    std::vector<int>  live;      // per-vertex faces not yet emitted
+    std::vector<int>  stamp;     // per-vertex cache time stamp
+    std::vector<char> emitted;   // per-face
+    std::vector<int>  dead_end;  // recently used vertices, most recent last
+    std::vector<int>  cand;      // corners of the faces just emitted
+
+    size_t capacity_bytes() const {
+        return (live.capacity() + stamp.capacity() + dead_end.capacity() + cand.capacity()) * sizeof(int) + emitted.capacity();
+    }
+};
+
+// Tipsify emission order of the faces for which alive[fi] is set (all faces if alive is
+// nullptr), written to `order` as face indices. faces_of(v) returns a [begin, end) pair of
+// const int* over v's incident faces; the lists may also hold faces that are not alive.
+template <class FacesOf>
+void tipsify_order(const Tri* faces, size_t nf, size_t nv, FacesOf faces_of, const char* alive,
+                   int cache_size, TipsifyScratch& sc, std::vector<int>& order) {
+    auto live_face = [&](int fi) { return !alive || alive[fi]; };
+    sc.live.assign(nv, 0); sc.stamp.assign(nv, 0); sc.emitted.assign(nf, 0);
+    sc.dead_end.clear(); sc.cand.clear(); order.clear();
+    for (size_t v = 0; v < nv; ++v) {
+        auto r = faces_of((int)v);
+        for (const int* it = r.first; it != r.second; ++it) sc.live[v] += live_face(*it);
+    }
+    int* live = sc.live.data(); int* stamp = sc.stamp.data();
+    int t = cache_size + 1;  // time: a vertex is cached while t - stamp[v] <= cache_size
+    size_t cursor = 0;
+    auto next_cursor = [&]() { while (cursor < nv && live[cursor] <= 0) ++cursor; return cursor < nv ? (int)cursor : -1; };
+    int f = next_cursor();
+    while (f >= 0) {
+        sc.cand.clear();
+        auto r = faces_of(f);
+        for (const int* it = r.first; it != r.second; ++it) {
+            const int fi = *it;
+            if (!live_face(fi) || sc.emitted[(size_t)fi]) continue;
+            sc.emitted[(size_t)fi] = 1; order.push_back(fi);
+            const Tri& tri = faces[fi];
+            for (int v : {tri.a, tri.b, tri.c}) {
+                sc.dead_end.push_back(v); sc.cand.push_back(v);
+                live[v]--;
+                if (t - stamp[v] > cache_size) stamp[v] = t++;
+            }
+        }
+        // Next fanning vertex: the candidate that stays cached longest once its remaining
+        // faces are emitted (2 new cache entries per face at worst); 0 if it would not.
+        int best = -1, best_p = -1;
+        for (int v : sc.cand) {
+            if (live[v] <= 0) continue;
+            const int p = t - stamp[v] + 2 * live[v] <= cache_size ? t - stamp[v] : 0;
+            if (p > best_p) { best_p = p; best = v; }
+        }
+        if (best < 0) {
+            while (!sc.dead_end.empty()) { const int d = sc.dead_end.back(); sc.dead_end.pop_back(); if (live[d] > 0) { best = d; break; } }
+            if (best < 0) best = next_cursor();
+        }
+        f = best;
+    }
+}
+
+// Average cache miss ratio (vertex transforms per face) of `faces` under a FIFO cache of
+// `cache_size` entries: about 3 for random order, 0.5-0.7 for well ordered manifolds.
+double vertex_cache_acmr(const std::vector<Tri>& faces, size_t nv, int cache_size = kReorderCacheSize);
+
+// Reorder mesh.faces (face_uvs / face_ids kept aligned) and renumber its vertices in first-use
+// order; unreferenced vertices are dropped. Instantiated for Mesh and MeshF.
+template <class T>
+void reorder_for_vertex_cache(MeshT<T>& mesh, int cache_size = kReorderCacheSize);
@@ -0,0 +1,103 @@
+// serve.cpp — stdin/stdout job loop for `meshqem --serve`.
+
+#include "serve.hpp"
+#include "cli.hpp"
+#include "thread_pool.hpp"
+#include "workspace.hpp"
+#include <atomic>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Split a request line into arguments; honours "..." quoting. Returns false on an
+// unterminated quote.
+static bool split_args(const std::string& line, std::vector<std::string>& out) {
+    out.clear();
+    size_t i = 0, n = line.size();
+    while (i < n) {
+        while (i < n && (line[i] == ' ' || line[i] == '\t' || line[i] == '\r')) ++i;
+        if (i >= n) break;
+        std::string tok;
+        if (line[i] == '"') {
+            for (++i; i < n && line[i] != '"'; ++i) {
+                if (line[i] == '\\' && i + 1 < n && (line[i + 1] == '"' || line[i + 1] == '\\')) ++i;
+                tok += line[i];
+            }
+            if (i >= n) return false;
+            ++i;
+        } else {
+            while (i < n && line[i] != ' ' && line[i] != '\t' && line[i] != '\r') tok += line[i++];
+        }
+        out.push_back(std::move(tok));
+    }
+    return true;
+}
+
+int serve_stdio(int threads) {
+    ThreadPool pool(threads);
+    std::mutex out_m;  // one reply line at a time
+    auto reply = [&out_m](const std::string& s) {
+        std::lock_guard<std::mutex> lk(out_m);
+        std::fwrite(s.data(), 1, s.size(), stdout);
+        std::fflush(stdout);
+    };
+
+    // Cancel flags of the jobs not yet replied to, by id (ids may repeat).
+    std::mutex jobs_m;
+    std::unordered_multimap<std::string, std::shared_ptr<std::atomic<bool>>> pending;
+
+    std::string line;
+    std::vector<std::string> args;
+    while (std::getline(std::cin, line)) {
+        if (!split_args(line, args)) { reply("- error 2 unterminated quote\n"); continue; }
+        if (args.empty() || args[0][0] == '#') continue;
+        if (args[0] == "quit") break;
+        if (args[0] == "cancel") {
+            if (args.size() != 2) { reply("- error 2 usage: cancel <id>\n"); continue; }
+            std::lock_guard<std::mutex> lk(jobs_m);
+            auto r = pending.equal_range(args[1]);
+            if (r.first == r.second) reply(args[1] + " error 2 cancel: no pending job with this id\n");
+            for (auto it = r.first; it != r.second; ++it) it->second->store(true, std::memory_order_relaxed);
+            continue;
+        }
+        const std::string id = args[0];
+        args.erase(args.begin());
+
+        auto job = std::make_shared<CliJob>();
+        std::string err;
+        if (!parse_job_args(args, *job, err)) { reply(id + " error 2 " + err + "\n"); continue; }
+        bool threads_given = false;
+        for (const auto& a : args) if (a == "--threads") threads_given = true;
+        if (!threads_given) job->opt.threads = 1;  // parallelism comes from running jobs side by side
+        auto cancel = std::make_shared<std::atomic<bool>>(false);
+        job->opt.cancel = cancel.get();
+        { std::lock_guard<std::mutex> lk(jobs_m); pending.emplace(id, cancel); }
+
+        pool.submit([job, id, cancel, &reply, &jobs_m, &pending] {
+            SimplifyReport rep;
+            std::string err;
+            static thread_local SimplifyWorkspace ws;  // per worker, warm across jobs
+            int rc = 6;
+            if (cancel->load(std::memory_order_relaxed)) err = "Cancelled";  // cancelled while queued
+            else rc = run_job(*job, rep, err, &ws);
+            {
+                std::lock_guard<std::mutex> lk(jobs_m);
+                for (auto r = pending.equal_range(id); r.first != r.second; ++r.first)
+                    if (r.first->second == cancel) { pending.erase(r.first); break; }
+            }
+            char buf[160];
+            if (rc == 0) {
+                std::snprintf(buf, sizeof(buf), " ok faces: %zu -> %zu verts: %zu -> %zu", rep.faces_before, rep.faces_after, rep.verts_before, rep.verts_after);
+                reply(id + buf + (job->stats_json ? " stats: " + stats_to_json(rep) : std::string()) + "\n");
+            } else {
+                reply(id + " error " + std::to_string(rc) + " " + err + "\n");
+            }
+        });
+    }
+    pool.wait();
+    return 0;
+}
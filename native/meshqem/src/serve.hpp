@@ -0,0 +1,25 @@
+// serve.hpp — Long-running job server for the meshqem executable (`meshqem --serve`).
+//
+// Protocol (line-framed, UTF-8, one request per line on stdin):
+//
+//     <id> <job flags...>        e.g.  17 --in "a b.obj" --out a.mqb --ratio 0.25
+//     cancel <id>                abort the queued or running job(s) with that id
+//     quit                       finish queued jobs and exit (EOF does the same)
+//
+// Job flags are the regular CLI flags (see kJobFlagsHelp); arguments may be double-quoted,
+// with \" and \\ escapes inside quotes. Blank lines and lines starting with '#' are ignored.
+// Each job produces exactly one reply line on stdout, in completion order:
+//
+//     <id> ok faces: <before> -> <after> verts: <before> -> <after> [stats: {...}]
+//     <id> error <exit code> <message>          (a cancelled job: "<id> error 6 Cancelled")
+//
+// A running job sees a cancel within kPollCollapses collapse iterations and writes no output.
+// Jobs run on a persistent ThreadPool, so worker threads (and their malloc arenas) stay
+// warm for the whole session; each worker also keeps a SimplifyWorkspace, so scratch
+// buffers are reused from job to job. A job's own --threads defaults to 1 here.
+//
+#pragma once
+
+// Serve requests from stdin until EOF or "quit", running up to `threads` jobs at once
+// (<=0 = all hardware threads). Returns the process exit code.
+int serve_stdio(int threads);
@@ -0,0 +1,277 @@
+// stream.cpp — Chunked out-of-core driver (see stream.hpp).
+
+#include "stream.hpp"
+#include "io_bin.hpp"
+#include "io_obj.hpp"
+#include "mapped_file.hpp"
+#include "workspace.hpp"
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+namespace {
+
+constexpr int kMortonBits = 6;                   // 64^3 cells, as in partitioned mode
+constexpr size_t kMinChunkFaces = 65536;         // below this most of a chunk is seam band
+constexpr size_t kMaxChunks = 4096;              // one open index file per chunk
+
+// Registered temporary files are removed when this goes out of scope.
+struct TempFiles {
+    std::vector<std::string> paths;
+    std::string add(const std::string& p) { paths.push_back(p); return p; }
+    ~TempFiles() { for (const auto& p : paths) std::remove(p.c_str()); }
+};
+
+struct Input {
+    MappedFile file;
+    MeshBinView view;
+    size_t nv = 0, nf = 0;
+    Vec3 pos(size_t i) const {
+        if (view.verts_f64) return {view.verts_f64[3 * i], view.verts_f64[3 * i + 1], view.verts_f64[3 * i + 2]};
+        return {view.verts_f32[3 * i], view.verts_f32[3 * i + 1], view.verts_f32[3 * i + 2]};
+    }
+    Tri face(size_t i) const { return {view.faces[3 * i], view.faces[3 * i + 1], view.faces[3 * i + 2]}; }
+};
+
+// Face centroid -> Morton cell over the input bounding box.
+struct MortonGrid {
+    double lo[3], sc[3];
+    static uint32_t spread(uint32_t x) { uint32_t r = 0; for (int i = 0; i < kMortonBits; ++i) r |= ((x >> i) & 1u) << (3 * i); return r; }
+    uint32_t cell(const Vec3& a, const Vec3& b, const Vec3& c) const {
+        const double m[3] = {(a.x + b.x + c.x) / 3, (a.y + b.y + c.y) / 3, (a.z + b.z + c.z) / 3};
+        uint32_t q[3];
+        for (int k = 0; k < 3; ++k) q[k] = (uint32_t)std::min((double)((1 << kMortonBits) - 1), std::max(0.0, (m[k] - lo[k]) * sc[k]));
+        return spread(q[0]) | spread(q[1]) << 1 | spread(q[2]) << 2;
+    }
+};
+
+inline int resolve_target(size_t faces0, double ratio, int target_faces) {
+    return target_faces > 0 ? target_faces : (int)std::max(0.0, std::floor((double)faces0 * std::min(1.0, std::max(0.0, ratio))));
+}
+
+// target_faces / ratio pair asking resolve_target for exactly `t` faces.
+inline void set_target(SimplifyOptions& o, int t) { o.target_faces = t > 0 ? t : -1; o.ratio = 0.0; }
+
+} // namespace
+
+bool stream_simplify(const std::string& in_path, bool obj_input, const SimplifyOptions& opt, const StreamConfig& cfg,
+                     Mesh& out, SimplifyReport& rep, std::string& err) {
+    using clock = std::chrono::steady_clock;
+    auto since = [](clock::time_point t) { return std::chrono::duration<double>(clock::now() - t).count(); };
+    const clock::time_point t_start = clock::now();
+    rep = SimplifyReport{};
+    out.clear();
+    if (opt.weld_eps >= 0) { err = "--weld is not supported in streaming mode"; return false; }
+    if (opt.method == SimplifyMethod::Cluster) { err = "--method cluster is not supported in streaming mode"; return false; }
+
+    TempFiles tmp;
+    std::string bin_path = in_path;
+    if (obj_input) {
+        bin_path = tmp.add(cfg.tmp_prefix + ".stream-in.mqb");
+        if (!convert_obj_to_bin(in_path, bin_path, err, opt.threads)) return false;
+    }
+    Input in;
+    if (!in.file.open(bin_path, err)) return false;
+    if (!open_mesh_bin(in.file, in.view, err)) { err += " in: " + in_path; return false; }
+    in.nv = (size_t)in.view.header->num_verts; in.nf = (size_t)in.view.header->num_faces;
+    const size_t nv = in.nv, nf = in.nf;
+    if (nv == 0 || nf == 0) { err = "empty mesh from: " + in_path; return false; }
+    const bool has_uv = in.view.uvs != nullptr;
+
+    // Pass 1: bounding box, index check, Morton histogram.
+    clock::time_point t = clock::now();
+    double lo[3] = {HUGE_VAL, HUGE_VAL, HUGE_VAL}, hi[3] = {-HUGE_VAL, -HUGE_VAL, -HUGE_VAL};
+    for (size_t i = 0; i < nv; ++i) {
+        const Vec3 p = in.pos(i); const double c[3] = {p.x, p.y, p.z};
+        for (int k = 0; k < 3; ++k) { lo[k] = std::min(lo[k], c[k]); hi[k] = std::max(hi[k], c[k]); }
+    }
+    MortonGrid grid;
+    double d2 = 0;
+    for (int k = 0; k < 3; ++k) {
+        grid.lo[k] = lo[k];
+        grid.sc[k] = hi[k] > lo[k] ? (double)(1 << kMortonBits) / (hi[k] - lo[k]) : 0.0;
+        if (hi[k] > lo[k]) d2 += (hi[k] - lo[k]) * (hi[k] - lo[k]);
+    }
+    const size_t cells = (size_t)1 << (3 * kMortonBits);
+    std::vector<size_t> hist(cells, 0);
+    for (size_t fi = 0; fi < nf; ++fi) {
+        const Tri f = in.face(fi);
+        if ((unsigned)f.a >= nv || (unsigned)f.b >= nv || (unsigned)f.c >= nv) { err = "MQB: face index out of range in: " + in_path; return false; }
+        hist[grid.cell(in.pos((size_t)f.a), in.pos((size_t)f.b), in.pos((size_t)f.c))]++;
+    }
+
+    // Chunk size from the budget, after the per-vertex seam map and the cell tables.
+    const int target = resolve_target(nf, opt.ratio, opt.target_faces);
+    const double max_error = opt.max_error >= 0 && opt.max_error_relative ? opt.max_error * std::sqrt(d2) : opt.max_error;
+    const size_t per_face = kStreamBytesPerFace + (has_uv ? kStreamUvBytesPerFace : 0);
+    const size_t fixed = nv * sizeof(int) + cells * (sizeof(size_t) + sizeof(int));
+    const size_t cap = cfg.budget_bytes > fixed ? (cfg.budget_bytes - fixed) / per_face : 0;
+    auto mib = [](size_t b) { return std::to_string((b + (1 << 20) - 1) >> 20) + " MiB"; };
+    if (nf <= cap) {
+        // Fits as a whole: plain in-memory run.
+        in.file.close();
+        if (!load_mesh_bin(bin_path, out, err)) return false;
+        return qem_simplify(out, opt, rep);
+    }
+    if ((size_t)target > cap) { err = "a target of " + std::to_string(target) + " faces needs about " + mib((size_t)target * per_face + fixed) + "; raise --stream-budget"; return false; }
+    if (cap < kMinChunkFaces) { err = "budget too small, need at least " + mib(kMinChunkFaces * per_face + fixed); return false; }
+    const size_t nchunks = (nf + cap - 1) / cap;
+    if (nchunks > kMaxChunks) { err = "budget too small, need at least " + mib((nf + kMaxChunks - 1) / kMaxChunks * per_face + fixed); return false; }
+
+    // Pass 2: consecutive Morton cells -> chunks of about equal face count; face indices to
+    // per-chunk files; seam detection (owner -2 = used by two chunks).
+    std::vector<int> chunk_of(cells);
+    {
+        size_t acc = 0; size_t c = 0;
+        for (size_t i = 0; i < cells; ++i) { chunk_of[i] = (int)c; acc += hist[i]; while (c + 1 < nchunks && acc >= nf * (c + 1) / nchunks) c++; }
+    }
+    std::vector<std::string> idx_path(nchunks), res_path(nchunks);
+    std::vector<std::FILE*> idx(nchunks, nullptr);
+    auto close_all = [&]() { for (auto& f : idx) { if (f) std::fclose(f); f = nullptr; } };
+    for (size_t c = 0; c < nchunks; ++c) {
+        idx_path[c] = tmp.add(cfg.tmp_prefix + ".stream-" + std::to_string(c) + ".idx");
+        res_path[c] = tmp.add(cfg.tmp_prefix + ".stream-" + std::to_string(c) + ".mqb");
+        idx[c] = std::fopen(idx_path[c].c_str(), "wb");
+        if (!idx[c]) { close_all(); err = "cannot write: " + idx_path[c]; return false; }
+    }
+    std::vector<int> seam(nv, -1);  // owner chunk while bucketing, then seam id (or -1)
+    std::vector<size_t> chunk_faces(nchunks, 0);
+    bool wrote = true;
+    for (size_t fi = 0; fi < nf && wrote; ++fi) {
+        const Tri f = in.face(fi);
+        const int c = chunk_of[grid.cell(in.pos((size_t)f.a), in.pos((size_t)f.b), in.pos((size_t)f.c))];
+        const int32_t id = (int32_t)fi;
+        wrote = std::fwrite(&id, sizeof(id), 1, idx[(size_t)c]) == 1;
+        chunk_faces[(size_t)c]++;
+        for (int x : {f.a, f.b, f.c}) { int& o = seam[(size_t)x]; if (o == -1) o = c; else if (o != c) o = -2; }
+    }
+    for (auto& f : idx) { wrote = std::fclose(f) == 0 && wrote; f = nullptr; }
+    if (!wrote) { err = "cannot write chunk index files next to " + cfg.tmp_prefix; return false; }
+    int nseam = 0;
+    for (int& o : seam) o = o == -2 ? nseam++ : -1;
+    double t_partition = since(t);
+
+    // Pass 3: each chunk on its own, seam vertices (ascending global index) first and locked,
+    // then the interior vertices in ascending order.
+    t = clock::now();
+    SimplifyWorkspace ws;
+    std::vector<std::vector<int>> chunk_seam(nchunks);
+    std::vector<char> produced(nchunks, 0);
+    SimplifyStats cl;                 // chunk counters, folded into the report at the end
+    double cl_error = 0;
+    size_t cl_scratch = 0, f_before = 0;
+    for (size_t c = 0; c < nchunks; ++c) {
+        const size_t n = chunk_faces[c];
+        const size_t f0 = f_before; f_before += n;
+        if (n == 0) { std::remove(idx_path[c].c_str()); continue; }
+        std::vector<int32_t> fidx(n);
+        std::FILE* fp = std::fopen(idx_path[c].c_str(), "rb");
+        const bool got = fp && std::fread(fidx.data(), sizeof(int32_t), n, fp) == n;
+        if (fp) std::fclose(fp);
+        std::remove(idx_path[c].c_str());
+        if (!got) { err = "cannot read: " + idx_path[c]; return false; }
+
+        std::vector<int>& sv = chunk_seam[c];
+        std::vector<int> iv;
+        for (int32_t fi : fidx) { const Tri f = in.face((size_t)fi); for (int x : {f.a, f.b, f.c}) (seam[(size_t)x] >= 0 ? sv : iv).push_back(x); }
+        std::sort(sv.begin(), sv.end()); sv.erase(std::unique(sv.begin(), sv.end()), sv.end());
+        std::sort(iv.begin(), iv.end()); iv.erase(std::unique(iv.begin(), iv.end()), iv.end());
+        Mesh m;
+        m.verts.reserve(sv.size() + iv.size());
+        for (int x : sv) m.verts.push_back(in.pos((size_t)x));
+        for (int x : iv) m.verts.push_back(in.pos((size_t)x));
+        auto lid = [&](int x) {
+            if (seam[(size_t)x] >= 0) return (int)(std::lower_bound(sv.begin(), sv.end(), x) - sv.begin());
+            return (int)sv.size() + (int)(std::lower_bound(iv.begin(), iv.end(), x) - iv.begin());
+        };
+        int seam_faces = 0;
+        m.faces.reserve(n); if (has_uv) m.face_uvs.reserve(n);
+        for (int32_t fi : fidx) {
+            const Tri f = in.face((size_t)fi);
+            m.faces.push_back({lid(f.a), lid(f.b), lid(f.c)});
+            seam_faces += seam[(size_t)f.a] >= 0 || seam[(size_t)f.b] >= 0 || seam[(size_t)f.c] >= 0;
+            if (has_uv) { std::array<double, 6> uv; std::copy(in.view.uvs + 6 * (size_t)fi, in.view.uvs + 6 * (size_t)fi + 6, uv.begin()); m.face_uvs.push_back(uv); }
+        }
+        std::vector<int>().swap(iv); std::vector<int32_t>().swap(fidx);
+        std::vector<char> lock(m.verts.size(), 0);
+        std::fill(lock.begin(), lock.begin() + (long)sv.size(), (char)1);
+
+        // Proportional share of the target plus the seam band, as in partitioned mode.
+        const int share = (int)((long long)target * (long long)(f0 + n) / (long long)nf - (long long)target * (long long)f0 / (long long)nf);
+        SimplifyOptions lo = opt;
+        set_target(lo, std::min((int)n, share + seam_faces));
+        lo.max_collapses = opt.max_collapses > 0 ? (int)((long long)opt.max_collapses * (long long)n / (long long)nf) : -1;
+        lo.max_error = max_error; lo.max_error_relative = false;
+        lo.time_limit = -1.0; lo.partitions = 0;
+        lo.progress_interval = INT_MAX; lo.progress = nullptr;
+        SimplifyReport crep;
+        qem_simplify_locked(m, lock, lo, crep, &ws);
+        fprintf(stderr, "[cpp] stream chunk %zu/%zu: faces %zu -> %zu\n", c + 1, nchunks, n, m.faces.size());
+        if (!m.faces.empty()) {
+            if (!save_mesh_bin(res_path[c], m, err)) return false;
+            produced[c] = 1;
+        }
+
+        const SimplifyStats& cs = crep.stats;
+        cl.clusters++;
+        cl.collapses += cs.collapses; cl.heap_pushes += cs.heap_pushes; cl.stale_pops += cs.stale_pops;
+        cl.solve_fallbacks += cs.solve_fallbacks; cl.degenerate_faces += cs.degenerate_faces;
+        cl.flip_rejects += cs.flip_rejects; cl.link_rejects += cs.link_rejects;
+        cl.peak_heap = std::max(cl.peak_heap, cs.peak_heap);
+        cl.error_limited = cl.error_limited || cs.error_limited;
+        cl_error = std::max(cl_error, crep.final_error);
+        cl_scratch = std::max(cl_scratch, crep.scratch_bytes);
+        if (cs.cancelled || (opt.cancel && opt.cancel->load(std::memory_order_relaxed))) { cl.cancelled = true; break; }
+    }
+    const double t_clusters = since(t);
+
+    // Pass 4: stitch on the seam vertices (locked, so every chunk holds the same copy), then
+    // the final pass over everything.
+    t = clock::now();
+    in.file.close();
+    out.verts.resize((size_t)nseam);
+    for (size_t c = 0; c < nchunks && !cl.cancelled; ++c) {
+        if (!produced[c]) continue;
+        Mesh m;
+        if (!load_mesh_bin(res_path[c], m, err)) return false;
+        std::remove(res_path[c].c_str());
+        const std::vector<int>& sv = chunk_seam[c];
+        const int k = (int)sv.size(), base = (int)out.verts.size() - k;
+        for (int i = 0; i < k; ++i) out.verts[(size_t)seam[(size_t)sv[(size_t)i]]] = m.verts[(size_t)i];
+        out.verts.insert(out.verts.end(), m.verts.begin() + k, m.verts.end());
+        auto gid = [&](int i) { return i < k ? seam[(size_t)sv[(size_t)i]] : base + i; };
+        for (const Tri& f : m.faces) out.faces.push_back({gid(f.a), gid(f.b), gid(f.c)});
+        if (has_uv) out.face_uvs.insert(out.face_uvs.end(), m.face_uvs.begin(), m.face_uvs.end());
+    }
+    std::vector<int>().swap(seam); std::vector<std::vector<int>>().swap(chunk_seam);
+    t_partition += since(t);
+
+    if (!cl.cancelled) {
+        SimplifyOptions fo = opt;
+        set_target(fo, target);
+        fo.max_error = max_error; fo.max_error_relative = false;
+        if (opt.max_collapses > 0) fo.max_collapses = std::max(1, opt.max_collapses - (int)cl.collapses);
+        if (opt.time_limit > 0) fo.time_limit = std::max(1e-9, opt.time_limit - since(t_start));
+        if (!qem_simplify(out, fo, rep, &ws)) { err = "Simplify failed"; return false; }
+    }
+
+    // Report the whole run: input counts, chunk counters folded into the final pass's.
+    SimplifyStats& st = rep.stats;
+    rep.faces_before = nf; rep.verts_before = nv;
+    rep.faces_after = out.faces.size(); rep.verts_after = out.verts.size();
+    st.clusters = cl.clusters;
+    st.collapses += cl.collapses; st.heap_pushes += cl.heap_pushes; st.stale_pops += cl.stale_pops;
+    st.solve_fallbacks += cl.solve_fallbacks; st.degenerate_faces += cl.degenerate_faces;
+    st.flip_rejects += cl.flip_rejects; st.link_rejects += cl.link_rejects;
+    st.peak_heap = std::max(st.peak_heap, cl.peak_heap);
+    st.error_limited = st.error_limited || cl.error_limited;
+    st.cancelled = st.cancelled || cl.cancelled;
+    rep.final_error = std::max(rep.final_error, cl_error);
+    rep.scratch_bytes = std::max(rep.scratch_bytes, cl_scratch);
+    if (opt.collect_stats) { st.t_partition += t_partition; st.t_clusters = t_clusters; }
+    return true;
+}
@@ -0,0 +1,41 @@
+// stream.hpp — Out-of-core simplification for meshes larger than memory (CLI --stream-budget).
+//
+// The input is never loaded as a whole: it is memory-mapped as MQB (an OBJ input is first
+// converted to a temporary MQB file by convert_obj_to_bin) and processed in four passes:
+// 1. bounding box, then a histogram of face centroids over a depth-6 Morton grid;
+// 2. consecutive Morton cells are grouped into chunks of about equal face count, as many as
+//    the budget needs (spatially compact, like partitioned mode's clusters); every face index
+//    is appended to its chunk's index file, and vertices used by two chunks become seam
+//    vertices;
+// 3. chunk by chunk: the chunk's faces are gathered into a Mesh, simplified with its seam
+//    vertices locked (qem_simplify_locked) toward its share of the target plus the faces
+//    touching the seam, and written to a temporary MQB file;
+// 4. the chunk results are stitched on their shared seam vertices and a final in-memory pass
+//    (qem_simplify with the caller's options) collapses the seams down to the target.
+// Peak memory stays near the budget: one chunk at a time plus 4 bytes per input vertex for
+// the seam map. The mapped input is read-only page cache the OS can drop under pressure and
+// is not counted. The stitched mesh (target plus seam band) is held in memory for the final
+// pass, so the target must fit the budget; that is checked up front. An input that fits the
+// budget as a whole is simply loaded and simplified in memory.
+//
+#pragma once
+#include "qem.hpp"
+#include <cstddef>
+#include <string>
+
+// Estimated peak bytes per input face of an in-memory qem_simplify run (mesh storage plus
+// workspace, the heap dominating), and the extra for per-face UVs. Used to size the chunks.
+constexpr size_t kStreamBytesPerFace = 320;
+constexpr size_t kStreamUvBytesPerFace = 112;
+
+struct StreamConfig {
+    size_t budget_bytes = 0;          // memory budget for the whole run
+    std::string tmp_prefix;           // temporary files are tmp_prefix + ".stream-*"; removed on return
+};
+
+// Simplify the MQB (or, with obj_input, OBJ) file at in_path into `out`. `opt` as for
+// qem_simplify, except that weld_eps and method=Cluster are rejected (false with a message in
+// `err`) and time_limit bounds the final pass only. rep.stats.clusters is the number of
+// chunks (0 when the input fit the budget).
+bool stream_simplify(const std::string& in_path, bool obj_input, const SimplifyOptions& opt, const StreamConfig& cfg,
+                     Mesh& out, SimplifyReport& rep, std::string& err);
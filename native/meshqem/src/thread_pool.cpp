@@ -0,0 +1,80 @@
+// thread_pool.cpp — Worker loop, submission and stealing for ThreadPool.
+
+#include "thread_pool.hpp"
+#include "parallel.hpp"
+
+static thread_local int tls_worker = -1;
+static thread_local const ThreadPool* tls_pool = nullptr;
+
+int ThreadPool::current_worker() { return tls_worker; }
+
+ThreadPool::ThreadPool(int threads) {
+    int n = resolve_threads(threads);
+    for (int i = 0; i < n; ++i) queues_.emplace_back(new Queue);
+    for (int i = 0; i < n; ++i) workers_.emplace_back([this, i] { run(i); });
+}
+
+ThreadPool::~ThreadPool() {
+    { std::lock_guard<std::mutex> lk(m_); stop_ = true; }
+    wake_.notify_all();
+    for (auto& t : workers_) t.join();
+}
+
+void ThreadPool::submit(std::function<void()> task) {
+    // Tasks submitted from a worker stay on that worker's deque (better locality);
+    // external submissions are dealt round-robin.
+    int self = tls_pool == this ? tls_worker : -1;
+    size_t q = self >= 0 ? (size_t)self : next_.fetch_add(1) % queues_.size();
+    {
+        // Counted before the task becomes visible, so queued_ never underflows; it is bumped
+        // under m_ so a worker that just found nothing and is about to sleep cannot miss it.
+        std::lock_guard<std::mutex> lk(m_);
+        pending_++;
+        queued_++;
+    }
+    {
+        std::lock_guard<std::mutex> lk(queues_[q]->m);
+        queues_[q]->tasks.push_back(std::move(task));
+    }
+    wake_.notify_one();
+}
+
+void ThreadPool::wait() {
+    std::unique_lock<std::mutex> lk(m_);
+    idle_.wait(lk, [this] { return pending_ == 0; });
+    if (error_) { std::exception_ptr e = error_; error_ = nullptr; std::rethrow_exception(e); }
+}
+
+bool ThreadPool::try_take(int self, std::function<void()>& task) {
+    const int n = (int)queues_.size();
+    {   // own deque: front first
+        Queue& q = *queues_[self];
+        std::lock_guard<std::mutex> lk(q.m);
+        if (!q.tasks.empty()) { task = std::move(q.tasks.front()); q.tasks.pop_front(); return true; }
+    }
+    for (int k = 1; k < n; ++k) {  // steal from the back of the others, starting with the next worker
+        Queue& q = *queues_[(self + k) % n];
+        std::lock_guard<std::mutex> lk(q.m);
+        if (!q.tasks.empty()) { task = std::move(q.tasks.back()); q.tasks.pop_back(); return true; }
+    }
+    return false;
+}
+
+void ThreadPool::run(int self) {
+    tls_worker = self; tls_pool = this;
+    for (;;) {
+        std::function<void()> task;
+        if (try_take(self, task)) {
+            queued_--;
+            std::exception_ptr err;
+            try { task(); } catch (...) { err = std::current_exception(); }
+            std::lock_guard<std::mutex> lk(m_);
+            if (err && !error_) error_ = err;
+            if (--pending_ == 0) idle_.notify_all();
+            continue;
+        }
+        std::unique_lock<std::mutex> lk(m_);
+        wake_.wait(lk, [this] { return stop_ || queued_.load() > 0; });
+        if (stop_ && queued_.load() == 0) return;
+    }
+}
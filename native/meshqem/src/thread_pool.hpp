@@ -0,0 +1,58 @@
+// thread_pool.hpp — Small persistent work-stealing thread pool.
+//
+// Design goals:
+// - Long-lived workers, for callers that run many independent jobs (batch simplification).
+//   One-shot data-parallel loops use parallel_for() in parallel.hpp instead.
+// - One mutex-protected deque per worker. submit() deals tasks round-robin; a worker pops
+//   its own deque from the front (so tasks submitted largest-first start largest-first),
+//   and an idle worker steals from the back of another worker's deque.
+// - wait() blocks until every submitted task has finished and rethrows the first
+//   exception a task raised.
+//
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class ThreadPool {
+public:
+    // threads <= 0 means one worker per hardware thread.
+    explicit ThreadPool(int threads);
+    ~ThreadPool();
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Queue a task. Safe to call from any thread, including from inside a task.
+    void submit(std::function<void()> task);
+    // Block until all tasks submitted so far have run.
+    void wait();
+    // Number of worker threads.
+    int size() const { return (int)workers_.size(); }
+    // Index of the calling thread within the pool that owns it, or -1 for non-pool threads.
+    static int current_worker();
+
+private:
+    struct Queue { std::mutex m; std::deque<std::function<void()>> tasks; };
+
+    void run(int self);
+    bool try_take(int self, std::function<void()>& task);
+
+    std::vector<std::unique_ptr<Queue>> queues_;
+    std::vector<std::thread> workers_;
+    std::atomic<size_t> next_{0};   // round-robin cursor for submit()
+    std::atomic<size_t> queued_{0}; // tasks sitting in some deque
+
+    std::mutex m_;                  // guards the fields below and the sleep/wake protocol
+    std::condition_variable wake_;  // workers wait here for queued_ > 0 or stop_
+    std::condition_variable idle_;  // wait() waits here for pending_ == 0
+    size_t pending_ = 0;            // submitted but not yet finished
+    bool stop_ = false;
+    std::exception_ptr error_;
+};
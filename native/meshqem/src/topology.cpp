@@ -0,0 +1,42 @@
+// topology.cpp — Growth and compaction for VertexLists.
+// The hot accessors are inline in the header; only the rare slow paths live here.
+
+#include "topology.hpp"
+
+void VertexLists::reset(const std::vector<int>& sizes) {
+    spans.assign(sizes.size(), Span{});
+    size_t total = 0;
+    for (size_t v = 0; v < sizes.size(); ++v) {
+        spans[v].start = (int)total; spans[v].cap = sizes[v];
+        total += (size_t)sizes[v];
+    }
+    pool.assign(total, -1);
+    garbage = 0;
+    peak = pool.capacity();
+}
+
+void VertexLists::grow(int v) {
+    // Reclaim abandoned slots first when they dominate the pool; this keeps the pool
+    // within a small constant factor of the live entries.
+    if (garbage > pool.size() / 2) compact();
+    Span& s = spans[v];
+    int cap = s.cap < 4 ? 4 : s.cap * 2;
+    int start = (int)pool.size();
+    pool.resize(pool.size() + (size_t)cap, -1);
+    for (int i = 0; i < s.count; ++i) pool[start + i] = pool[s.start + i];
+    garbage += s.cap;
+    s.start = start; s.cap = cap;
+    if (pool.capacity() > peak) peak = pool.capacity();
+}
+
+void VertexLists::compact() {
+    std::vector<int> packed;
+    packed.reserve(pool.size() - garbage);
+    for (auto& s : spans) {
+        int start = (int)packed.size();
+        packed.insert(packed.end(), pool.begin() + s.start, pool.begin() + s.start + s.count);
+        s.start = start; s.cap = s.count;
+    }
+    pool.swap(packed);
+    garbage = 0;
+}
@@ -0,0 +1,85 @@
+// topology.hpp — Flat per-vertex index lists used by the QEM collapse loop.
+//
+// Design goals:
+// - One shared int pool for every vertex's list, no per-vertex heap allocation.
+// - Lists start out packed CSR-style; a list that outgrows its slot is moved to the
+//   end of the pool with doubled capacity (amortized O(1) append).
+// - Abandoned slots are reclaimed by compact() once they outweigh the live data.
+//
+// Typical use in qem.cpp: vertex -> incident faces, so a collapse only visits the
+// faces around the removed vertex instead of scanning the whole face array.
+// EdgeTable below maps undirected edges to their faces for the boundary / UV-seam pass.
+//
+#pragma once
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+struct VertexLists {
+    // Slot of one list inside `pool`: entries live in [start, start+count).
+    struct Span { int start{}, count{}, cap{}; };
+
+    std::vector<Span> spans; // one span per vertex
+    std::vector<int>  pool;  // backing storage shared by all lists
+    size_t garbage = 0;      // pool entries no longer referenced by any span
+    size_t peak = 0;         // largest pool capacity seen since reset() (scratch accounting)
+
+    // Build packed lists from per-vertex sizes; entries are then filled with push().
+    // Storage is reused: existing capacity is kept across resets.
+    void reset(const std::vector<int>& sizes);
+
+    int  size(int v) const { return spans[v].count; }
+    int* begin(int v) { return pool.data() + spans[v].start; }
+    int* end(int v) { return pool.data() + spans[v].start + spans[v].count; }
+    const int* begin(int v) const { return pool.data() + spans[v].start; }
+    const int* end(int v) const { return pool.data() + spans[v].start + spans[v].count; }
+
+    // Append x to list v, relocating the list when its slot is full.
+    void push(int v, int x) {
+        Span& s = spans[v];
+        if (s.count == s.cap) grow(v);
+        pool[spans[v].start + spans[v].count++] = x;
+    }
+    // Shrink list v to its first n entries (used after in-place filtering).
+    void truncate(int v, int n) { spans[v].count = n; }
+    // Drop list v entirely; its slot becomes garbage.
+    void release(int v) { garbage += spans[v].cap; spans[v] = Span{}; }
+
+    // Repack all lists contiguously and drop garbage.
+    void compact();
+
+private:
+    void grow(int v);
+};
+
+// Open-addressing hash map from an undirected edge (u,v) to its first two faces, filled in
+// one linear pass over the faces. Storage is reused across resets.
+struct EdgeTable {
+    struct Slot { uint64_t key; int f0, f1; };  // f1: -1 one face so far, -2 three or more
+    static constexpr uint64_t kEmpty = ~(uint64_t)0;
+
+    std::vector<Slot> slots;
+    int shift = 64;
+
+    // Empty table for up to `edges` distinct edges (load factor <= 3/4).
+    void reset(size_t edges) {
+        size_t n = 16; int bits = 4;
+        while (n < edges + edges / 3) { n <<= 1; ++bits; }
+        slots.assign(n, Slot{kEmpty, -1, -1});
+        shift = 64 - bits;
+    }
+    static uint64_t key(int u, int v) { if (u > v) std::swap(u, v); return (uint64_t)(uint32_t)u << 32 | (uint32_t)v; }
+    static int key_u(uint64_t k) { return (int)(k >> 32); }
+    static int key_v(uint64_t k) { return (int)(uint32_t)k; }
+
+    void add(int u, int v, int face) {
+        const uint64_t k = key(u, v);
+        const size_t mask = slots.size() - 1;
+        for (size_t h = (size_t)((k * 0x9E3779B97F4A7C15ull) >> shift);; h = (h + 1) & mask) {
+            Slot& s = slots[h];
+            if (s.key == kEmpty) { s = Slot{k, face, -1}; return; }
+            if (s.key == k) { s.f1 = s.f1 == -1 ? face : -2; return; }
+        }
+    }
+};
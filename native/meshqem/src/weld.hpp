@@ -0,0 +1,22 @@
+// weld.hpp — Merge coincident vertices before simplification.
+//
+// Triangle soup (one private vertex per face corner, typical of face-varying USD data)
+// leaves QEM with no shared edges to collapse. weld_vertices() merges every vertex within
+// `eps` of an earlier vertex into it, using a hashed uniform grid of cell size 4*eps:
+// - cell keys are computed in parallel and bucketed by their top bits (parallel count,
+//   scatter and per-bucket sort) into a sorted (key, vertex) table, indexed by a directory
+//   on the top key bits;
+// - vertices are then assigned in index order to the lowest-index representative within eps
+//   found in the (up to 27) surrounding cells, so the result is deterministic for any thread count.
+// Faces are remapped; faces that lose a corner to the weld are removed together with
+// their face_uvs / face_ids entries, so both stay aligned with faces.
+//
+#pragma once
+#include "mesh.hpp"
+#include <cstddef>
+
+// Weld vertices closer than `eps` (eps == 0 merges exact duplicates only).
+// Representatives keep their position; unreferenced vertices are kept. Returns the number
+// of vertices removed. Instantiated for Mesh and MeshF; distances are compared in double.
+template <class T>
+size_t weld_vertices(MeshT<T>& mesh, double eps, int threads = 1);
@@ -0,0 +1,42 @@
+// workspace.hpp — Reusable scratch memory for qem_simplify.
+//
+// Every per-run buffer of the simplifier (quadrics, flags, incidence/adjacency pools,
+// heap, compaction arrays) lives here. Buffers are cleared, never freed, between runs, so
+// repeated calls on one workspace stop hitting the allocator once the largest mesh has
+// been seen. A workspace is not thread-safe: use one per thread (batch and --serve keep a
+// thread_local one per worker).
+//
+#pragma once
+#include "qem.hpp"
+#include "topology.hpp"
+#include "reorder.hpp"
+#include <cstddef>
+#include <vector>
+
+struct SimplifyWorkspace {
+    std::vector<char>     face_alive;
+    std::vector<char>     v_alive;
+    std::vector<int>      deg;      // per-vertex list sizes while building vf/adj
+    VertexLists           vf;       // vertex -> incident faces
+    VertexLists           adj;      // vertex -> neighbor vertices
+    std::vector<int>      mark;     // dedupe stamps for list merges
+    std::vector<Quadric>  vq;       // per-vertex quadrics
+    std::vector<int>      ver;      // per-vertex version stamps for heap entries
+    std::vector<size_t>   off;      // per-vertex output offsets for the initial candidates
+    EdgeTable             edges;    // boundary / UV-seam detection (opt.boundary_weight, seam_weight)
+    std::vector<EdgeCand> heap;
+    std::vector<int>      remap;    // compaction: old -> new vertex index
+    std::vector<Vec3>     v2;       // compaction outputs; after a run they hold the input
+    std::vector<Tri>      f2;       //   mesh's old buffers (swapped), reused next time
+    std::vector<std::array<double, 6>> uv2;
+    std::vector<int>      id2;
+    std::vector<Vec3f>    v2f;      // the same for MeshF runs; a workspace may serve both
+    std::vector<std::array<float, 6>> uv2f;
+    std::vector<int>      order;    // opt.reorder: face emission order
+    TipsifyScratch        tips;
+
+    // Bytes currently reserved by all buffers (their high-water mark so far).
+    size_t capacity_bytes() const;
+    // Free everything (e.g. after an unusually large mesh).
+    void release() { *this = SimplifyWorkspace{}; }
+};